@@ -1,4 +1,5 @@
 #include "MemoryManager.h"
+#include "trace.h"
 
 #include <stddef.h>
 #include <stdint.h>
@@ -289,6 +290,7 @@ void *allocMemory(const size_t size)
     }
 
     g_freePages.freePages -= pagesNeeded;
+    TRACE(TRACE_ALLOC, size, pfn_to_address(runStart));
     return (void *)pfn_to_address(runStart);
 }
 
@@ -317,6 +319,7 @@ void freeMemory(void *blockAddress)
         return;
     }
 
+    TRACE(TRACE_FREE, 0, address);
     const uint32_t pagesInBlock = headPage->nextFree;
     if (pagesInBlock == 0u || headPFN + pagesInBlock > g_freePages.totalPages) {
         return;
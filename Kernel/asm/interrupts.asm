@@ -3,6 +3,7 @@ GLOBAL _cli
 GLOBAL _sti
 GLOBAL _hlt
 GLOBAL contextSwitch
+GLOBAL _yield
 
 GLOBAL picMasterMask
 GLOBAL picSlaveMask
@@ -10,6 +11,10 @@ GLOBAL picSlaveMask
 GLOBAL _irq00Handler
 GLOBAL _irq01Handler
 GLOBAL _irq80Handler
+GLOBAL _yieldHandler
+GLOBAL _syscallHandler
+GLOBAL _spuriousInterruptHandler
+GLOBAL signalTrampoline
 
 GLOBAL _exceptionHandler00
 GLOBAL _exceptionHandler06
@@ -20,8 +25,18 @@ GLOBAL register_snapshot_taken
 EXTERN irqDispatcher
 EXTERN syscallDispatcher
 EXTERN exceptionDispatcher
+EXTERN exceptionExit
 EXTERN getStackBase
 EXTERN schedule
+EXTERN runDeferredWork
+EXTERN lapicEOIRegister
+EXTERN irqEnter
+EXTERN irqExit
+EXTERN irqExitSince
+EXTERN readTSC
+EXTERN recordMaskedSection
+EXTERN profilerSample
+EXTERN signalReturn
 
 SECTION .text
 
@@ -65,15 +80,26 @@ SECTION .text
 	pop rax
 %endmacro
 
+; EOI (End of Interrupt) to the LAPIC through its memory mapped register, or to the PIC before the APICs are set up
+%macro signalEOI 0
+	mov rax, [lapicEOIRegister]
+	test rax, rax
+	jz %%pic
+	mov dword [rax], 0
+	jmp %%done
+%%pic:
+	mov al, 20h
+	out 20h, al
+%%done:
+%endmacro
+
 %macro irqHandlerMaster 1
 	pushState
 
 	mov rdi, %1 ; pass argument to irqDispatcher
 	call irqDispatcher
 
-	; signal pic EOI (End of Interrupt)
-	mov al, 20h
-	out 20h, al
+	signalEOI
 
 	popState
 	iretq
@@ -117,6 +143,9 @@ SECTION .text
 	
 	call exceptionDispatcher
 
+	mov rdi, %1
+	call exceptionExit ; does not return if the faulting process has a parent to report to
+
 	call getStackBase ; reset the stack
 	mov [rsp + 0x18], rax
 
@@ -126,16 +155,41 @@ SECTION .text
 	iretq ; will pop USERLAND and jmp to it
 %endmacro
 
+; `_cli` stamps the TSC (unless a masked section is already open), `_sti` and `_hlt` record how long it lasted
+; `_hlt` ends the section too: its `sti` is what lets the interrupt it waits for in
 _hlt:
+	mov rdi, [maskedSince]
+	test rdi, rdi
+	jz .halt
+	mov qword [maskedSince], 0
+	sub rsp, 8 ; 16-byte alignment for the call
+	call recordMaskedSection
+	add rsp, 8
+.halt:
 	sti
 	hlt
 	ret
 
 _cli:
 	cli
+	cmp qword [maskedSince], 0
+	jne .end
+	rdtsc
+	shl rdx, 32
+	or rax, rdx
+	mov [maskedSince], rax
+.end:
 	ret
 
 _sti:
+	mov rdi, [maskedSince]
+	test rdi, rdi
+	jz .enable
+	mov qword [maskedSince], 0
+	sub rsp, 8 ; 16-byte alignment for the call
+	call recordMaskedSection
+	add rsp, 8
+.enable:
 	sti
 	ret
 
@@ -143,6 +197,20 @@ contextSwitch:
 	int 20h
 	ret
 
+; Gives the CPU away right now instead of waiting for the next tick (see `_yieldHandler`)
+; Like `_hlt` it ends the masked section; the caller resumes with interrupts masked and calls `_cli` again
+_yield:
+	mov rdi, [maskedSince]
+	test rdi, rdi
+	jz .switch
+	mov qword [maskedSince], 0
+	sub rsp, 8 ; 16-byte alignment for the call
+	call recordMaskedSection
+	add rsp, 8
+.switch:
+	int 81h
+	ret
+
 picMasterMask:
 	push rbp     ; Stack frame
 	mov rbp, rsp
@@ -169,13 +237,26 @@ picSlaveMask:
 _irq00Handler:
 	pushState
 
+	mov rdi, IRQ_SOURCE_TIMER
+	call irqEnter
+
+	mov rdi, rsp ; where the interrupted process was, for the profiler
+	call profilerSample
+
+	mov rdi, 0 ; tick bookkeeping (ticks, kernel data page, cursor) before switching
+	call irqDispatcher
+
 	mov rdi, rsp ; le pasa el contexto de la tarea anterior para guardarlo en pcb
 	call schedule ; devuelve puntero al stack del nuevo proceso
 	mov rsp, rax ; el stack pointer apunta al stack del nuevo proceso
 
-	; signal pic EOI (End of Interrupt)
-	mov al, 20h
-	out 20h, al
+	signalEOI
+
+	mov rdi, IRQ_SOURCE_TIMER
+	call irqExit
+
+	call runDeferredWork ; bottom halves, with interrupts enabled
+	mov qword [maskedSince], 0 ; masked from its last item up to iretq, part of the handler
 
 	popState
 	iretq
@@ -185,6 +266,9 @@ _irq01Handler:
 	pushfq
 	pushState
 
+	mov rdi, IRQ_SOURCE_KEYBOARD
+	call irqEnter
+
 	mov rdi, 1 ; pass argument to irqDispatcher
 	call irqDispatcher
 
@@ -221,35 +305,110 @@ _irq01Handler:
 	mov byte [register_snapshot_taken], 0x01
 
 	.skip:
-	; signal pic EOI (End of Interrupt)
-	mov al, 20h
-	out 20h, al
+	signalEOI
+
+	mov rdi, IRQ_SOURCE_KEYBOARD
+	call irqExit
+
+	call runDeferredWork ; bottom halves, with interrupts enabled
+	mov qword [maskedSince], 0 ; masked from its last item up to iretq, part of the handler
 
 	popState
 	add rsp, 0x08 ; remove rflags from the stack
 
 	iretq
 
+; Software switch raised by `_yield`: no IRQ behind it, so no tick bookkeeping and no EOI
+_yieldHandler:
+	pushState
+
+	mov rdi, rsp
+	call schedule
+	mov rsp, rax
+
+	mov qword [maskedSince], 0 ; the resumed context either iretqs with interrupts on or calls `_cli` again
+
+	popState
+	iretq
+
 ; System Call
 ; Not using the %irqHandlerMaster macro because it needs to pass the stack pointer to the syscall
 _irq80Handler:
 	pushState
 
-	mov rdi, rsp ; pass REGISTERS (stack) to irqDispatcher, see: `pushState` two lines above
-	call syscallDispatcher
+	call readTSC
+	mov r13, rax ; entry stamp, callee saved so it survives the call even if it blocks. Restored by popStateButRAX
 
-	mov rbx, rax
+	mov rdi, rsp ; pass REGISTERS (stack) to irqDispatcher, see: `pushState` above
+	call syscallDispatcher
 
-	; signal pic EOI (End of Interrupt)
-	mov al, 20h
-	out 20h, al
+	; No PIC EOI: `int 80h` is a software interrupt, the PIC never raised it
 
-	mov rax, rbx
+	mov r12, rax ; r12 is restored by popStateButRAX
+	mov rdi, IRQ_SOURCE_INT80
+	mov rsi, r13
+	call irqExitSince
+	mov rax, r12
 
 	popStateButRAX
 	add rsp, 8 ; skip the error code pushed by irqDispatcher
 	iretq
 
+; System Call, SYSCALL instruction entry (see `setup_syscall_entry`)
+; rcx holds the return address and r11 the caller's RFLAGS, the 4th argument comes in r10 instead of rcx
+; Lean convention: libsys stubs are plain function calls, so only the argument registers are saved,
+; into a `Registers` frame (r10 goes in the rcx slot) so `syscallDispatcher` reads them as usual. The rest of the slots are not filled
+; Everything runs in ring 0, so it returns with popfq + jmp instead of SYSRET (which always drops to ring 3)
+_syscallHandler:
+	sub rsp, SYSCALL_FRAME_SIZE
+
+	mov [rsp + REGISTERS_RAX], rax
+	mov [rsp + REGISTERS_RDI], rdi
+	mov [rsp + REGISTERS_RSI], rsi
+	mov [rsp + REGISTERS_RDX], rdx
+	mov [rsp + REGISTERS_RCX], r10
+	mov [rsp + REGISTERS_R8], r8
+	mov [rsp + REGISTERS_R9], r9
+	mov [rsp + REGISTERS_R11], r11
+	mov [rsp + REGISTERS_RIP], rcx
+
+	call readTSC
+	mov [rsp + SYSCALL_ENTRY_STAMP], rax
+
+	mov rdi, rsp
+	call syscallDispatcher
+
+	mov [rsp + REGISTERS_RAX], rax ; the result, across `irqExitSince`
+	mov rdi, IRQ_SOURCE_SYSCALL
+	mov rsi, [rsp + SYSCALL_ENTRY_STAMP]
+	call irqExitSince
+	mov rax, [rsp + REGISTERS_RAX]
+
+	mov r11, [rsp + REGISTERS_R11]
+	mov rcx, [rsp + REGISTERS_RIP]
+	add rsp, SYSCALL_FRAME_SIZE
+
+	push r11
+	popfq
+	jmp rcx
+
+; Entered through the frame `signalDeliver` builds: rdi -> signal, rsi -> handler, rsp -> `SignalFrame` (16-byte aligned)
+; Runs the handler on the process' stack, then resumes the interrupted code from the copy of its state
+signalTrampoline:
+	call rsi
+
+	cli ; nothing may switch away while the interrupted state is being restored, iretq brings its RFLAGS back
+	mov rdi, rsp
+	call signalReturn
+
+	add rsp, 0x10 ; skip to `SignalFrame.interrupted`
+	popState
+	iretq
+
+; LAPIC spurious interrupt: nothing was delivered, no EOI
+_spuriousInterruptHandler:
+	iretq
+
 ; Zero Division Exception
 _exceptionHandler00:
 	exceptionHandler 0
@@ -262,7 +421,27 @@ section .bss
 	exception_register_snapshot resq 18
 	register_snapshot resq 18
 	register_snapshot_taken resb 1
+	maskedSince resq 1 ; TSC at the `_cli` that opened the current masked section, 0 if none
 
 section .rodata
 	REGISTER_SNAPSHOT_KEY_SCANCODE equ 0x58 ; F12 KEY SCANCODE
+
+	; `Registers` (syscallDispatcher.h) field offsets
+	REGISTERS_R11 equ 0x08 * 4
+	REGISTERS_R9 equ 0x08 * 6
+	REGISTERS_R8 equ 0x08 * 7
+	REGISTERS_RSI equ 0x08 * 8
+	REGISTERS_RDI equ 0x08 * 9
+	REGISTERS_RDX equ 0x08 * 11
+	REGISTERS_RCX equ 0x08 * 12
+	REGISTERS_RAX equ 0x08 * 14
+	REGISTERS_RIP equ 0x08 * 15
+	SYSCALL_FRAME_SIZE equ 0x08 * 17 ; `Registers` + 8 bytes, stubs are entered with rsp 8 bytes off 16-byte alignment
+	SYSCALL_ENTRY_STAMP equ 0x08 * 16 ; the padding slot after `Registers`, `syscallDispatcher` never sees it
+	; `irq_stats_abi.h` sources
+	IRQ_SOURCE_TIMER equ 0
+	IRQ_SOURCE_KEYBOARD equ 1
+	IRQ_SOURCE_INT80 equ 2
+	IRQ_SOURCE_SYSCALL equ 3
+
 	USERLAND equ 0x400000 ; userland (shell module address)
@@ -12,9 +12,18 @@ GLOBAL setSpeaker
 GLOBAL getRegisterSnapshot
 
 GLOBAL stackInit
+GLOBAL processExitTrampoline
+
+GLOBAL readMSR
+GLOBAL writeMSR
+GLOBAL readTSC
+
+GLOBAL inb
+GLOBAL outb
 
 EXTERN register_snapshot
 EXTERN register_snapshot_taken
+EXTERN exitCurrentProcess
 
 section .text
 
@@ -167,3 +176,46 @@ stackInit:
     pop rbp
 
     ret
+
+
+; Return address of every process entry point (see `createProcess`)
+; exits with the value the entry point returned
+processExitTrampoline:
+	mov edi, eax
+	call exitCurrentProcess ; does not return
+
+; rdi -> MSR index
+readMSR:
+	mov ecx, edi
+	rdmsr
+	shl rdx, 32
+	or rax, rdx
+	ret
+
+; rdi -> MSR index, rsi -> value
+writeMSR:
+	mov ecx, edi
+	mov eax, esi
+	mov rdx, rsi
+	shr rdx, 32
+	wrmsr
+	ret
+
+readTSC:
+	rdtsc
+	shl rdx, 32
+	or rax, rdx
+	ret
+
+; rdi -> port
+inb:
+	mov edx, edi
+	in al, dx
+	ret
+
+; rdi -> port, rsi -> value
+outb:
+	mov edx, edi
+	mov eax, esi
+	out dx, al
+	ret
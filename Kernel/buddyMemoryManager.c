@@ -1,4 +1,5 @@
 #include "MemoryManager.h"
+#include "trace.h"
 
 #include <stddef.h>
 #include <stdint.h>
@@ -216,6 +217,7 @@ void *allocMemory(const size_t size)
 		freeBytes = 0;
 	}
 
+	TRACE(TRACE_ALLOC, size, header + 1);
 	return (void *)(header + 1);
 }
 
@@ -243,6 +245,7 @@ void freeMemory(void *blockAddress)
 		return;
 	}
 
+	TRACE(TRACE_FREE, 0, blockAddress);
 	BlockHeader *header = (BlockHeader *)blockAddress - 1;
 	int order = header->order;
 	void *current_block = header;
@@ -2,6 +2,7 @@
 #include <time.h>
 #include <fonts.h>
 #include <keyboard.h>
+#include <scrollback.h>
 
 #define TOGGLE_TICKS 9
 
@@ -17,6 +18,7 @@ int toggleSpeed(void) {
 
 void toggleCursor(void) {
     int toggle = toggleSpeed() % 2;
+    if (scrollbackIsPaging()) return; // would jump back to the live screen
     if (keyboard_options == 0 || keyboard_options == MODIFY_BUFFER){
         IS_SHOWING = 0;
     } else{
@@ -0,0 +1,49 @@
+#include <deferredWork.h>
+#include <interrupts.h>
+#include <irqStats.h>
+#include <lib.h>
+
+typedef struct {
+    DeferredWork work;
+    uint64_t arg;
+} WorkItem;
+
+// Written by IRQ handlers (tail) and by `runDeferredWork` (head), both with interrupts disabled
+static WorkItem queue[DEFERRED_WORK_QUEUE_SIZE];
+static uint32_t head = 0, tail = 0;
+static volatile uint8_t running = 0;
+
+uint8_t queueDeferredWork(DeferredWork work, uint64_t arg) {
+    if (tail - head == DEFERRED_WORK_QUEUE_SIZE) {
+        return 0;
+    }
+
+    WorkItem * item = &queue[tail % DEFERRED_WORK_QUEUE_SIZE];
+    item->work = work;
+    item->arg = arg;
+    tail++;
+    return 1;
+}
+
+void runDeferredWork(void) {
+    if (running) {
+        return; // an interrupt arrived while the queue was being run, the outer loop picks up its work
+    }
+
+    running = 1;
+    while (head != tail) {
+        WorkItem item = queue[head % DEFERRED_WORK_QUEUE_SIZE];
+        head++;
+
+        _sti();
+        uint64_t start = readTSC();
+        item.work(item.arg);
+        recordIrqCycles(IRQ_SOURCE_DEFERRED, readTSC() - start);
+        _cli();
+    }
+    running = 0;
+}
+
+uint8_t deferredWorkIsRunning(void) {
+    return running;
+}
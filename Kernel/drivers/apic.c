@@ -0,0 +1,145 @@
+#include <apic.h>
+#include <interrupts.h>
+#include <lib.h>
+#include <time.h>
+#include <sound.h>
+
+// Pure64 system variables (see `Bootloader/Pure64/src/sysvar.asm`)
+#define PURE64_LAPIC_ADDRESS ((volatile uint64_t *) 0x5A28)
+#define PURE64_IOAPIC_TABLE ((volatile uint32_t *) 0x5A30) // { address, first GSI } for each IOAPIC
+#define PURE64_IOAPIC_COUNT ((volatile uint8_t *) 0x5BA8)
+
+// Local APIC registers, offsets from its base
+#define LAPIC_ID 0x020
+#define LAPIC_TPR 0x080
+#define LAPIC_EOI 0x0B0
+#define LAPIC_SVR 0x0F0
+#define LAPIC_LVT_TIMER 0x320
+#define LAPIC_TIMER_INITIAL 0x380
+#define LAPIC_TIMER_CURRENT 0x390
+#define LAPIC_TIMER_DIVIDE 0x3E0
+
+#define LAPIC_SVR_ENABLE 0x100
+#define LAPIC_LVT_MASKED 0x10000
+#define LAPIC_TIMER_PERIODIC 0x20000
+#define LAPIC_TIMER_DIVIDE_BY_16 0x3
+
+// IOAPIC, registers are accessed through a select/window pair
+#define IOAPIC_REGSEL 0x00
+#define IOAPIC_WINDOW 0x10
+#define IOAPIC_VERSION 0x01
+#define IOAPIC_REDIRECTION(n) (0x10 + 2 * (n))
+#define IOAPIC_MASKED 0x10000 // fixed delivery, physical destination, edge triggered, active high otherwise
+
+// PIT channel 2, only used once to calibrate the LAPIC timer. Its gate is controlled through port 0x61
+#define PIT_FREQUENCY 1193182
+#define PIT_CHANNEL2_ONE_SHOT 0xB0 // channel 2, lobyte/hibyte, mode 0 (interrupt on terminal count)
+#define PIT_GATE_PORT 0x61
+#define PIT_GATE 0x01
+#define PIT_SPEAKER 0x02
+#define PIT_OUT2 0x20
+#define CALIBRATION_MS 10
+
+volatile uint32_t * lapicEOIRegister = 0;
+
+static volatile uint8_t * lapic;
+
+static inline uint32_t lapicRead(uint32_t reg) {
+	return *(volatile uint32_t *) (lapic + reg);
+}
+
+static inline void lapicWrite(uint32_t reg, uint32_t value) {
+	*(volatile uint32_t *) (lapic + reg) = value;
+}
+
+static uint32_t ioapicRead(uint64_t base, uint8_t reg) {
+	*(volatile uint32_t *) (base + IOAPIC_REGSEL) = reg;
+	return *(volatile uint32_t *) (base + IOAPIC_WINDOW);
+}
+
+static void ioapicWrite(uint64_t base, uint8_t reg, uint32_t value) {
+	*(volatile uint32_t *) (base + IOAPIC_REGSEL) = reg;
+	*(volatile uint32_t *) (base + IOAPIC_WINDOW) = value;
+}
+
+static uint32_t ioapicEntries(uint64_t base) {
+	return ((ioapicRead(base, IOAPIC_VERSION) >> 16) & 0xFF) + 1;
+}
+
+// Masks every input, then sends `gsi` to `vector` on this CPU. ISA IRQs are identity mapped to GSIs
+// (no interrupt source override for the keyboard on the platforms we run on)
+static uint8_t routeIoapic(uint32_t gsi, uint8_t vector) {
+	uint8_t routed = 0;
+	uint32_t destination = lapicRead(LAPIC_ID) >> 24;
+
+	for (uint8_t i = 0; i < *PURE64_IOAPIC_COUNT; i++) {
+		uint64_t base = PURE64_IOAPIC_TABLE[2 * i];
+		uint32_t firstGsi = PURE64_IOAPIC_TABLE[2 * i + 1];
+		uint32_t entries = ioapicEntries(base);
+
+		for (uint32_t n = 0; n < entries; n++) {
+			ioapicWrite(base, IOAPIC_REDIRECTION(n), IOAPIC_MASKED);
+		}
+
+		if (gsi >= firstGsi && gsi < firstGsi + entries) {
+			ioapicWrite(base, IOAPIC_REDIRECTION(gsi - firstGsi) + 1, destination << 24);
+			ioapicWrite(base, IOAPIC_REDIRECTION(gsi - firstGsi), vector);
+			routed = 1;
+		}
+	}
+
+	return routed;
+}
+
+// LAPIC timer counts (divided by 16) in CALIBRATION_MS, measured against PIT channel 2
+static uint32_t calibrateLapicTimer(void) {
+	uint8_t gate = inb(PIT_GATE_PORT);
+	outb(PIT_GATE_PORT, (gate & ~(PIT_SPEAKER | PIT_GATE)));
+
+	uint16_t count = PIT_FREQUENCY * CALIBRATION_MS / 1000;
+	setPITMode(PIT_CHANNEL2_ONE_SHOT);
+	setPITFrequency(count);
+
+	lapicWrite(LAPIC_TIMER_DIVIDE, LAPIC_TIMER_DIVIDE_BY_16);
+	lapicWrite(LAPIC_LVT_TIMER, LAPIC_LVT_MASKED);
+
+	outb(PIT_GATE_PORT, (gate & ~PIT_SPEAKER) | PIT_GATE); // raising the gate starts the count
+	lapicWrite(LAPIC_TIMER_INITIAL, 0xFFFFFFFF);
+
+	while ((inb(PIT_GATE_PORT) & PIT_OUT2) == 0);
+
+	uint32_t elapsed = 0xFFFFFFFF - lapicRead(LAPIC_TIMER_CURRENT);
+	lapicWrite(LAPIC_TIMER_INITIAL, 0);
+	outb(PIT_GATE_PORT, gate);
+	return elapsed;
+}
+
+uint8_t initApic(void) {
+	uint64_t lapicAddress = *PURE64_LAPIC_ADDRESS;
+	if (lapicAddress == 0 || *PURE64_IOAPIC_COUNT == 0) {
+		picMasterMask(KEYBOARD_PIC_MASTER & TIMER_PIC_MASTER);
+		picSlaveMask(NO_INTERRUPTS);
+		return 0;
+	}
+
+	picMasterMask(NO_INTERRUPTS);
+	picSlaveMask(NO_INTERRUPTS);
+
+	lapic = (volatile uint8_t *) lapicAddress;
+	lapicWrite(LAPIC_TPR, 0);
+	lapicWrite(LAPIC_SVR, LAPIC_SVR_ENABLE | APIC_SPURIOUS_VECTOR);
+
+	if (!routeIoapic(ISA_IRQ_KEYBOARD, APIC_KEYBOARD_VECTOR)) {
+		picMasterMask(KEYBOARD_PIC_MASTER & TIMER_PIC_MASTER);
+		return 0;
+	}
+
+	// Same period the PIT had, everything that counts ticks stays as is
+	uint64_t perTick = (uint64_t) calibrateLapicTimer() * TICK_NANOSECONDS / (CALIBRATION_MS * 1000000ULL);
+	lapicWrite(LAPIC_TIMER_DIVIDE, LAPIC_TIMER_DIVIDE_BY_16);
+	lapicWrite(LAPIC_LVT_TIMER, LAPIC_TIMER_PERIODIC | APIC_TIMER_VECTOR);
+	lapicWrite(LAPIC_TIMER_INITIAL, perTick > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t) perTick);
+
+	lapicEOIRegister = (volatile uint32_t *) (lapic + LAPIC_EOI);
+	return 1;
+}
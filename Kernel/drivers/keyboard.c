@@ -3,6 +3,8 @@
 #include <interrupts.h>
 #include <cursor.h>
 #include <stddef.h>
+#include <deferredWork.h>
+#include <signal.h>
 
 #define BUFFER_SIZE 1024
 
@@ -31,7 +33,10 @@
 #define SUB_MOD(a, b, m) ((a) - (b) < 0 ? (m) - (b) + (a) : (a) - (b))
 #define DEC_MOD(x, m) ((x) = SUB_MOD(x, 1, m))
 
+#define EXTENDED_KEY_PREFIX 0xE0
+
 static uint8_t SHIFT_KEY_PRESSED, CAPS_LOCK_KEY_PRESSED, CONTROL_KEY_PRESSED;
+static uint8_t EXTENDED_KEY_PENDING, EXTENDED_KEY; // 0xE0 prefixed scancodes (grey navigation keys, right control...)
 static int8_t buffer[BUFFER_SIZE];
 static uint16_t to_write = 0, to_read = 0;
 uint8_t keyboard_options = 0;
@@ -41,6 +46,8 @@ typedef struct {
     SpecialKeyHandler fn;
 } RegisteredKeys;
 
+static void processScancode(uint64_t arg);
+
 static RegisteredKeys KeyFnMap[ F12_KEY - ESCAPE_KEY + 1 ] = {0};
 static RegisteredKeys ControlKeyFnMap[ F12_KEY - ESCAPE_KEY + 1 ] = {0};
 
@@ -218,6 +225,15 @@ static uint8_t makeCode(uint8_t scancode) {
     return scancode & 0x7F;
 }
 
+uint8_t isShiftPressed(void) {
+    return SHIFT_KEY_PRESSED;
+}
+
+// Whether the key being handled was sent with the 0xE0 prefix, e.g. the grey PageUp instead of keypad 9
+uint8_t isExtendedKey(void) {
+    return EXTENDED_KEY;
+}
+
 void addCharToBuffer(int8_t ascii, uint8_t showOutput) {
     if (ascii != TABULATOR_CHAR) {
         buffer[to_write] = ascii;
@@ -257,14 +273,47 @@ int8_t getKeyboardCharacter(enum KEYBOARD_OPTIONS ops) {
     return aux;
 }
 
+// Non blocking, without echo. Keeps the buffer accepting keys while nothing has been typed yet
+uint8_t pollKeyboardCharacter(int8_t * c) {
+    if (to_write == to_read) {
+        keyboard_options |= MODIFY_BUFFER;
+        return 0;
+    }
+
+    *c = buffer[to_read];
+    INC_MOD(to_read, BUFFER_SIZE);
+    return 1;
+}
+
+// IRQ 1: only takes the scancode off the controller, the rest runs as deferred work
 uint8_t keyboardHandler(){
     uint8_t scancode = getKeyboardBuffer();
+    queueDeferredWork(processScancode, scancode);
+    return scancode;
+}
+
+// Bottom half, in scancode order. Registered key handlers run here with interrupts enabled
+static void processScancode(uint64_t arg) {
+    uint8_t scancode = (uint8_t) arg;
+
+    if (scancode == EXTENDED_KEY_PREFIX) {
+        EXTENDED_KEY_PENDING = 1;
+        return;
+    }
+    EXTENDED_KEY = EXTENDED_KEY_PENDING;
+    EXTENDED_KEY_PENDING = 0;
+
     uint8_t is_pressed = isPressed(scancode);
     uint8_t code = makeCode(scancode);
 
+    // Fake shifts sent around grey keys would otherwise drop the real shift state
+    if (EXTENDED_KEY && (code == SHIFT_KEY_L || code == SHIFT_KEY_R)) {
+        return;
+    }
+
     if(BUFFER_IS_FULL){
         to_read = to_write = 0;
-        return scancode; // do not write to buffer anymore, subsequent keys are not processed into the buffer
+        return; // do not write to buffer anymore, subsequent keys are not processed into the buffer
     }
     
     switch (code) {
@@ -280,14 +329,19 @@ uint8_t keyboardHandler(){
                 CAPS_LOCK_KEY_PRESSED = !CAPS_LOCK_KEY_PRESSED;
             break;
 
-        return scancode;
+        return;
     }
     
-    if (! (is_pressed && IS_KEYCODE(scancode)) ) return scancode; // ignore break or unsupported scancodes
+    if (! (is_pressed && IS_KEYCODE(scancode)) ) return; // ignore break or unsupported scancodes
+
+    // Ctrl+C interrupts the foreground process group, a registered handler only adds to it (echo, input line)
+    if (CONTROL_KEY_PRESSED && code == C_KEY) {
+        signalInterruptForeground();
+    }
 
     if (CONTROL_KEY_PRESSED && code >= ESCAPE_KEY && code <= F12_KEY && ControlKeyFnMap[code].fn != NULL) {
         ControlKeyFnMap[code].fn(code);
-        return scancode;
+        return;
     }
     
     if ((keyboard_options & MODIFY_BUFFER) != 0) {
@@ -297,12 +351,13 @@ uint8_t keyboardHandler(){
             c = TO_UPPER(c);
         }
 
-        if (IS_PRINTABLE(scancode)) {
+        // Grey keys share their scancodes with the keypad, but never type digits
+        if (IS_PRINTABLE(scancode) && !(EXTENDED_KEY && code >= KP_HOME_KEY && code <= KP_DELETE_KEY)) {
             if(c == RETURN_KEY){
                 c = NEW_LINE_CHAR;
-                // Handle \n on the keyboard interrupt handler, to avoid the possibility of triggering multiple \n inputs continously on the same sys_read
+                // Handle \n as the key is processed, to avoid the possibility of triggering multiple \n inputs continously on the same sys_read
                 if ( (to_write != to_read) && buffer[SUB_MOD(to_write, 1, BUFFER_SIZE)] == NEW_LINE_CHAR ) {
-                    return scancode;
+                    return;
                 }
             } else if(c == TABULATOR_KEY){
                 c = TABULATOR_CHAR;
@@ -319,7 +374,4 @@ uint8_t keyboardHandler(){
     if (KeyFnMap[scancode].fn != 0) {
         KeyFnMap[scancode].fn(scancode);
     }
-
-    return scancode;
-
 }
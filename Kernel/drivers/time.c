@@ -1,15 +1,89 @@
 #include <time.h>
 #include <interrupts.h>
+#include <lib.h>
 
 #include <fonts.h>
 #include<cursor.h>
+#include <ioRing.h>
+#include <deferredWork.h>
+
+#define BARRIER() __asm__ volatile ("" ::: "memory")
 
 static unsigned long ticks = 0;
+static uint8_t tickWorkQueued = 0;
+static uint64_t wallClockSecond = (uint64_t) -1; // second since boot the wall clock was last read at
+
+// Page aligned and alone in its page, so it can be handed out to userland as is
+static union {
+	KernelData data;
+	uint8_t page[KERNEL_DATA_PAGE_SIZE];
+} kernelDataPage __attribute__((aligned(KERNEL_DATA_PAGE_SIZE)));
+
+// Runs from the timer interrupt. Only ticks and the TSC, port I/O is left to `updateWallClock`
+static void updateKernelData(void) {
+	KernelData * data = &kernelDataPage.data;
+	uint64_t tsc = readTSC();
+
+	data->sequence++;
+	BARRIER();
+
+	if (data->ticks != 0) {
+		data->tscPerTick = tsc - data->tscAtTick;
+	}
+	data->ticks = ticks;
+	data->nanosecondsPerTick = TICK_NANOSECONDS;
+	data->nanoseconds = ticks * TICK_NANOSECONDS;
+	data->tscAtTick = tsc;
+
+	BARRIER();
+	data->sequence++;
+}
+
+// Reads the CMOS RTC once per second, from the tick's bottom half
+static void updateWallClock(void) {
+	uint64_t second = ticks / SECONDS_TO_TICKS;
+	if (second == wallClockSecond) {
+		return;
+	}
+	wallClockSecond = second;
+
+	uint8_t hours = getHour(), minutes = getMinute(), seconds = getSecond();
+	KernelData * data = &kernelDataPage.data;
+
+	_cli(); // the timer interrupt writes the page too
+	data->sequence++;
+	BARRIER();
+	data->hours = hours;
+	data->minutes = minutes;
+	data->seconds = seconds;
+	BARRIER();
+	data->sequence++;
+	_sti();
+}
+
+void setKernelDataPid(int pid) {
+	kernelDataPage.data.currentPid = pid;
+}
+
+const KernelData * getKernelData(void) {
+	return &kernelDataPage.data;
+}
+
+// Bottom half of the tick. Only queued once, it looks at the current tick count when it runs
+static void tickWork(uint64_t arg) {
+	tickWorkQueued = 0;
+	ioRingOnTick();
+	toggleCursor();
+	updateWallClock();
+}
 
 void timer_handler() {
 	ticks++;
+	updateKernelData();
 
-	toggleCursor();
+	if (!tickWorkQueued) {
+		tickWorkQueued = queueDeferredWork(tickWork, 0);
+	}
 }
 
 int ticks_elapsed() {
@@ -7,6 +7,7 @@
 
 #include <video.h>
 #include <interrupts.h>
+#include <stddef.h>
 
 struct vbe_mode_info_structure {
 	uint16_t attributes;		// deprecated, only bit 7 should be of interest to you, and it indicates the mode supports a linear frame buffer.
@@ -50,54 +51,214 @@ typedef struct vbe_mode_info_structure * VBEInfoPtr;
 
 VBEInfoPtr VBE_mode_info = (VBEInfoPtr) 0x0000000000005C00;
 
+// * Pixel format fast paths: 32bpp modes are written with a single store, 24bpp modes byte by byte *
+static inline uint8_t * pixelAddress(uint64_t x, uint64_t y) {
+	uint8_t * framebuffer = (uint8_t * )(unsigned long long)(VBE_mode_info->framebuffer);
+	return framebuffer + (x * ((VBE_mode_info->bpp) >> 3)) + (y * VBE_mode_info->pitch);
+}
+
+static inline void storePixel(uint8_t * pixel, uint32_t hexColor, uint8_t bytesPerPixel) {
+	if (bytesPerPixel == 4) {
+		*(uint32_t *) pixel = hexColor & 0x00FFFFFF;
+		return;
+	}
+	pixel[0] = (hexColor) & 0xFF;
+	pixel[1] = (hexColor >> 8) & 0xFF;
+	pixel[2] = (hexColor >> 16) & 0xFF;
+}
+
+// Bulk row writer, fills `length` pixels starting at (x, y). No clipping
+static inline void fillSpan(uint32_t hexColor, uint64_t x, uint64_t y, uint64_t length) {
+	uint8_t bytesPerPixel = VBE_mode_info->bpp >> 3;
+	uint8_t * pixel = pixelAddress(x, y);
+
+	if (bytesPerPixel == 4) {
+		uint32_t * dst = (uint32_t *) pixel;
+		uint32_t value = hexColor & 0x00FFFFFF;
+		while (length--) *dst++ = value;
+		return;
+	}
+
+	for (; length > 0; length--, pixel += bytesPerPixel) {
+		storePixel(pixel, hexColor, bytesPerPixel);
+	}
+}
+
 void putPixel(uint32_t hexColor, uint64_t x, uint64_t y) {
-    uint8_t * framebuffer = (uint8_t * )(unsigned long long)(VBE_mode_info->framebuffer);
-    uint64_t offset = (x * ((VBE_mode_info->bpp) >> 3)) + (y * VBE_mode_info->pitch);
-	uint8_t b = (hexColor) & 0xFF, g = (hexColor >> 8) & 0xFF, r = (hexColor >> 16) & 0xFF;
+	storePixel(pixelAddress(x, y), hexColor, VBE_mode_info->bpp >> 3);
+}
+
+// Fills row `y` from `x0` to `x1` (inclusive), clipped against the screen
+static inline void clippedSpan(uint32_t hexColor, int64_t x0, int64_t x1, int64_t y) {
+	int64_t width = getWindowWidth();
+	if (y < 0 || y >= getWindowHeight()) return;
+	if (x0 < 0) x0 = 0;
+	if (x1 >= width) x1 = width - 1;
+	if (x0 > x1) return;
+	fillSpan(hexColor, x0, y, x1 - x0 + 1);
+}
+
+// Clipped against the screen, position and size come from user space. Nothing is drawn if no pixel is left
+void drawRectangle(uint32_t hexColor, uint64_t width, uint64_t height, int64_t initial_pos_x, int64_t initial_pos_y){
+	int64_t screenWidth = getWindowWidth(), screenHeight = getWindowHeight();
+	if (width == 0 || height == 0 || initial_pos_x >= screenWidth || initial_pos_y >= screenHeight) return;
+
+	// Sizes past the screen edge are cut there, so the last column/row can not overflow
+	int64_t lastX = width > (uint64_t) screenWidth - (uint64_t) initial_pos_x ? screenWidth - 1 : initial_pos_x + (int64_t) width - 1;
+	int64_t lastY = height > (uint64_t) screenHeight - (uint64_t) initial_pos_y ? screenHeight - 1 : initial_pos_y + (int64_t) height - 1;
+
+	for (int64_t y = initial_pos_y < 0 ? 0 : initial_pos_y; y <= lastY; y++) {
+		clippedSpan(hexColor, initial_pos_x, lastX, y);
+	}
+}
+
+// `extent` is the half width of the row, `next` the one of the row right outside of it (-1 if none)
+// Columns span [-rx, rx), same as the original per-pixel test
+static inline void ellipseRow(uint32_t hexColor, int64_t centerX, int64_t y, int64_t extent, int64_t next, int64_t rx, uint8_t outline) {
+	int64_t right = extent < rx ? extent : rx - 1;
+	// Outline: only the pixels not covered by the next row, so the border stays connected
+	int64_t inner = next + 1 < extent ? next + 1 : extent;
+
+	if (!outline || inner == 0) {
+		clippedSpan(hexColor, centerX - extent, centerX + right, y);
+		return;
+	}
 
-    framebuffer[offset]     =  b;
-    framebuffer[offset+1]   =  g;
-    framebuffer[offset+2]   =  r;
+	clippedSpan(hexColor, centerX - extent, centerX - inner, y);
+	clippedSpan(hexColor, centerX + (inner < right ? inner : right), centerX + right, y);
 }
 
-void drawRectangle(uint32_t hexColor, uint64_t width, uint64_t height, uint64_t initial_pos_x, uint64_t initial_pos_y){
-	for(uint64_t y = initial_pos_y; y - initial_pos_y < height; y++){
-		for(uint64_t x = initial_pos_x; x - initial_pos_x < width; x++){
-			putPixel(hexColor, x, y);
+// Scanline rasterizer: the half width of each row is derived from the previous one (it only shrinks
+// moving away from the center), keeping x^2 * ry^2 and y^2 * rx^2 as running sums. Rows are then filled with `fillSpan`
+void drawEllipse(uint32_t hexColor, int64_t topLeftX, int64_t topLeftY, uint64_t width, uint64_t height, uint8_t outline) {
+	int64_t rx = width / 2, ry = height / 2;
+	if (rx == 0 || ry == 0) return;
+
+	int64_t centerX = topLeftX + rx, centerY = topLeftY + ry;
+	int64_t rx2 = rx * rx, ry2 = ry * ry, limit = rx2 * ry2;
+
+	int64_t x = rx, xTerm = limit, yTerm = 0;
+	int64_t previous = rx; // half width of row `k - 1`
+
+	for (int64_t k = 1; k <= ry; k++) {
+		yTerm += (2 * k - 1) * rx2;
+		while (x > 0 && xTerm + yTerm > limit) {
+			xTerm -= (2 * x - 1) * ry2;
+			x--;
 		}
+
+		// Row k - 1: above the center for k - 1 >= 1, below it for k - 1 < ry (rows span [-ry, ry))
+		if (k - 1 >= 1) ellipseRow(hexColor, centerX, centerY - (k - 1), previous, x, rx, outline);
+		ellipseRow(hexColor, centerX, centerY + (k - 1), previous, k < ry ? x : -1, rx, outline);
+		previous = x;
 	}
+
+	ellipseRow(hexColor, centerX, centerY - ry, previous, -1, rx, outline);
 }
 
 void drawCircle(uint32_t hexColor, uint64_t topLeftX, uint64_t topLeftY, uint64_t diameter) {
-    int64_t radius = diameter / 2;
-    int64_t centerX = topLeftX + radius;
-    int64_t centerY = topLeftY + radius;
-    
-    for (int64_t y = -radius; y < radius; y++) {
-        for (int64_t x = -radius; x < radius; x++) {
-            if (x * x + y * y <= radius * radius) {
-                putPixel(hexColor, centerX + x, centerY + y);
-            }
-        }
-    }
+	drawEllipse(hexColor, topLeftX, topLeftY, diameter, diameter, 0);
 }
 
+// Bresenham, pixels outside of the screen are skipped
+void drawLine(uint32_t hexColor, int64_t x0, int64_t y0, int64_t x1, int64_t y1) {
+	int64_t width = getWindowWidth(), height = getWindowHeight();
+	int64_t dx = x1 > x0 ? x1 - x0 : x0 - x1;
+	int64_t dy = y1 > y0 ? y0 - y1 : y1 - y0;
+	int64_t sx = x0 < x1 ? 1 : -1;
+	int64_t sy = y0 < y1 ? 1 : -1;
+	int64_t err = dx + dy;
+
+	while (1) {
+		if (x0 >= 0 && y0 >= 0 && x0 < width && y0 < height) {
+			putPixel(hexColor, x0, y0);
+		}
+		if (x0 == x1 && y0 == y1) {
+			break;
+		}
+		int64_t e2 = 2 * err;
+		if (e2 >= dy) { err += dy; x0 += sx; }
+		if (e2 <= dx) { err += dx; y0 += sy; }
+	}
+}
+
+// `pixels` is a row major 0x00RRGGBB bitmap. Clipped against the screen
+void drawBitmap(const uint32_t * pixels, uint64_t width, uint64_t height, int64_t x, int64_t y) {
+	BlitRequest request = {
+		.pixels = pixels,
+		.format = BITMAP_FORMAT_ARGB32,
+		.width = width,
+		.height = height,
+	};
+	blitBitmap(&request, x, y);
+}
+
+static inline uint32_t sourcePixel(const BlitRequest * request, uint64_t index) {
+	if (request->format == BITMAP_FORMAT_INDEXED8) {
+		return ((const uint8_t *) request->pixels)[index];
+	}
+	return ((const uint32_t *) request->pixels)[index] & 0x00FFFFFF;
+}
+
+// Copies a user bitmap to (x, y), see `BlitRequest`
+// Source pixels are fetched once per destination run, so scaled blits cost one lookup per source pixel
+int8_t blitBitmap(const BlitRequest * request, int64_t x, int64_t y) {
+	if (request == NULL || request->pixels == NULL) return -1;
+	if (request->format != BITMAP_FORMAT_ARGB32 && request->format != BITMAP_FORMAT_INDEXED8) return -1;
+	if (request->format == BITMAP_FORMAT_INDEXED8 && request->palette == NULL) return -1;
+
+	int64_t scale = request->scale == 0 ? 1 : request->scale;
+	int64_t stride = request->stride == 0 ? request->width : request->stride;
+
+	// Destination rectangle clipped against the screen and, optionally, the clip rectangle
+	int64_t left = 0, top = 0, right = getWindowWidth(), bottom = getWindowHeight();
+	if (request->flags & BLIT_CLIP) {
+		if (request->clipX > left) left = request->clipX;
+		if (request->clipY > top) top = request->clipY;
+		if (request->clipX + (int64_t) request->clipWidth < right) right = request->clipX + (int64_t) request->clipWidth;
+		if (request->clipY + (int64_t) request->clipHeight < bottom) bottom = request->clipY + (int64_t) request->clipHeight;
+	}
+
+	int64_t x0 = x > left ? x : left;
+	int64_t y0 = y > top ? y : top;
+	int64_t x1 = x + (int64_t) request->width * scale;
+	int64_t y1 = y + (int64_t) request->height * scale;
+	if (x1 > right) x1 = right;
+	if (y1 > bottom) y1 = bottom;
+	if (x0 >= x1 || y0 >= y1) return 0;
+
+	uint8_t bytesPerPixel = VBE_mode_info->bpp >> 3;
+	uint8_t useColorKey = (request->flags & BLIT_COLOR_KEY) != 0;
+	uint8_t indexed = request->format == BITMAP_FORMAT_INDEXED8;
+	uint32_t colorKey = indexed ? (request->colorKey & 0xFF) : (request->colorKey & 0x00FFFFFF);
+
+	for (int64_t dy = y0; dy < y1; dy++) {
+		uint64_t rowIndex = ((dy - y) / scale) * stride;
+		int64_t sx = (x0 - x) / scale;
+		int64_t repeat = scale - (x0 - x) % scale; // destination pixels left for the current source pixel
+		uint8_t * pixel = pixelAddress(x0, dy);
+
+		for (int64_t dx = x0; dx < x1; sx++) {
+			uint32_t value = sourcePixel(request, rowIndex + sx);
+			uint8_t skip = useColorKey && value == colorKey;
+			uint32_t color = indexed ? request->palette[value] : value;
+
+			for (; repeat > 0 && dx < x1; repeat--, dx++, pixel += bytesPerPixel) {
+				if (!skip) storePixel(pixel, color, bytesPerPixel);
+			}
+			repeat = scale;
+		}
+	}
+
+	return 0;
+}
 
 void fillVideoMemory(uint32_t hexColor) {
-	uint8_t * framebuffer = (uint8_t * )(unsigned long long)(VBE_mode_info->framebuffer);
 	uint16_t width = getWindowWidth();
 	uint16_t height = getWindowHeight();
 
-	uint8_t b = (hexColor) & 0xFF, g = (hexColor >> 8) & 0xFF, r = (hexColor >> 16) & 0xFF;
-	uint64_t yoffset;
 	for (uint16_t y = 0; y < height; y++) {
-		yoffset = (y * VBE_mode_info->pitch);
-		for (uint16_t x = 0; x < width; x++) {
-			uint64_t offset = (x * ((VBE_mode_info->bpp) >> 3)) + yoffset;
-			framebuffer[offset] = b;
-			framebuffer[offset + 1] = g;
-			framebuffer[offset + 2] = r;
-		}
+		fillSpan(hexColor, 0, y, width);
 	}
 }
 
@@ -109,40 +270,65 @@ uint16_t getWindowWidth() {
 	return VBE_mode_info->width;
 }
 
+// Moves the whole screen `scroll` rows up and fills the uncovered rows with `fillColor`
+// Visible rows are contiguous in the framebuffer, so everything below `scroll` is moved in one forward copy, 8 bytes at a time
 void scrollVideoMemoryUp(uint16_t scroll, uint32_t fillColor) {
+	uint16_t width = getWindowWidth();
+	uint16_t height = getWindowHeight();
+
+	if (scroll == 0) return;
+	if (scroll >= height) {
+		fillVideoMemory(fillColor);
+		return;
+	}
+
 	_cli();
 
 	uint8_t * framebuffer = (uint8_t * )(unsigned long long)(VBE_mode_info->framebuffer);
-	uint16_t width = getWindowWidth();
-	uint16_t height = getWindowHeight();
-	
-	uint8_t b = (fillColor) & 0xFF, g = (fillColor >> 8) & 0xFF, r = (fillColor >> 16) & 0xFF;
-
-	// Iterating over Y, then X
-	// -> Memory is contiguous in the framebuffer, increased cached hits, reduced tearing
-	uint64_t yoffset, ynoffset, offset, new_offset, xo;
-	for (uint16_t y = 0; y < height - scroll; y++) {
-		yoffset = (y * VBE_mode_info->pitch);
-		ynoffset = ((y + scroll) * VBE_mode_info->pitch);
-		for (uint16_t x = 0; x < width; x++) {
-			xo = (x * ((VBE_mode_info->bpp) >> 3));
-			offset = xo + yoffset;
-			new_offset = xo + ynoffset;
-			framebuffer[offset] = framebuffer[new_offset];
-			framebuffer[offset + 1] = framebuffer[new_offset + 1];
-			framebuffer[offset + 2] = framebuffer[new_offset + 2];
-		}
+	uint64_t pitch = VBE_mode_info->pitch;
+	uint64_t bytes = (height - scroll) * pitch;
+
+	uint64_t * dst = (uint64_t *) framebuffer;
+	const uint64_t * src = (const uint64_t *) (framebuffer + scroll * pitch);
+	uint64_t words = bytes >> 3;
+	for (uint64_t i = 0; i < words; i++) {
+		dst[i] = src[i];
+	}
+	for (uint64_t i = words << 3; i < bytes; i++) {
+		framebuffer[i] = framebuffer[i + scroll * pitch];
 	}
 
 	for (uint16_t y = height - scroll; y < height; y++) {
-		yoffset = (y * VBE_mode_info->pitch);
-		for (uint16_t x = 0; x < width; x++) {
-			offset = (x * ((VBE_mode_info->bpp) >> 3)) + yoffset;
-			framebuffer[offset] = b;
-			framebuffer[offset + 1] = g;
-			framebuffer[offset + 2] = r;
-		}
+		fillSpan(fillColor, 0, y, width);
 	}
 
 	_sti();
 }
+
+// Renders `count` glyphs side by side starting at (x, y), row by row across the whole run
+// Glyphs are 8 pixels wide, one byte per row (least significant bit first), `glyphHeight` rows each, scaled by `scale`
+// Characters outside of the font (>= 128) leave their cell untouched. Rows below the screen are skipped
+void drawGlyphRun(const char * glyphs, uint64_t count, const uint8_t * font, uint16_t glyphHeight, uint64_t x, uint64_t y, uint8_t scale, uint32_t hexColor, uint32_t backgroundColor) {
+	uint8_t bytesPerPixel = VBE_mode_info->bpp >> 3;
+	uint64_t height = getWindowHeight();
+	uint64_t cellBytes = 8 * scale * bytesPerPixel;
+
+	for (uint64_t row = 0; row < (uint64_t) glyphHeight * scale && y + row < height; row++) {
+		uint8_t * cell = pixelAddress(x, y + row);
+		uint64_t fontRow = row / scale;
+
+		for (uint64_t i = 0; i < count; i++, cell += cellBytes) {
+			uint8_t ascii = glyphs[i];
+			if (ascii >= 128) continue;
+
+			uint8_t bits = font[ascii * glyphHeight + fontRow];
+			uint8_t * pixel = cell;
+			for (uint8_t column = 0; column < 8; column++) {
+				uint32_t color = bits & (1 << column) ? hexColor : backgroundColor;
+				for (uint8_t s = 0; s < scale; s++, pixel += bytesPerPixel) {
+					storePixel(pixel, color, bytesPerPixel);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,233 @@
+#include <fileDescriptor.h>
+#include <stddef.h>
+#include <process.h>
+#include <pipe.h>
+#include <fonts.h>
+#include <keyboard.h>
+#include <lib.h>
+#include <deferredWork.h>
+
+#define STANDARD_FDS 3
+
+static FileDescriptor consoleTable[STANDARD_FDS] = {
+    { FD_CONSOLE, CONSOLE_STDIN },
+    { FD_CONSOLE, CONSOLE_STDOUT },
+    { FD_CONSOLE, CONSOLE_STDERR },
+};
+
+// Threads use the table of the process they belong to. Deferred work (key handlers) runs on whatever process was
+// interrupted, it gets the console instead of that process' descriptors
+static Process * currentOwner(void) {
+    return deferredWorkIsRunning() ? NULL : getOwnerProcess(getCurrentProcess());
+}
+
+// Kernel code running before the first process or from deferred work sees the console
+static FileDescriptor * descriptorIn(Process * process, int fd) {
+    if (fd < 0 || fd >= PROCESS_MAX_FDS) {
+        return NULL;
+    }
+
+    if (process == NULL) {
+        return fd < STANDARD_FDS ? &consoleTable[fd] : NULL;
+    }
+    return process->fds[fd].type == FD_CLOSED ? NULL : &process->fds[fd];
+}
+
+static FileDescriptor * descriptorOf(int fd) {
+    return descriptorIn(currentOwner(), fd);
+}
+
+static void retain(const FileDescriptor * descriptor) {
+    if (descriptor->type == FD_PIPE_READ) {
+        pipeOpen(descriptor->target, PIPE_READ_END);
+    } else if (descriptor->type == FD_PIPE_WRITE) {
+        pipeOpen(descriptor->target, PIPE_WRITE_END);
+    }
+}
+
+static void release(FileDescriptor * descriptor) {
+    if (descriptor->type == FD_PIPE_READ) {
+        pipeClose(descriptor->target, PIPE_READ_END);
+    } else if (descriptor->type == FD_PIPE_WRITE) {
+        pipeClose(descriptor->target, PIPE_WRITE_END);
+    }
+    descriptor->type = FD_CLOSED;
+    descriptor->target = 0;
+}
+
+void fdTableInit(FileDescriptor * table, const FileDescriptor * parentTable) {
+    for (int fd = 0; fd < PROCESS_MAX_FDS; fd++) {
+        table[fd].type = FD_CLOSED;
+        table[fd].target = 0;
+    }
+
+    for (int fd = 0; fd < STANDARD_FDS; fd++) {
+        table[fd] = parentTable == NULL || parentTable[fd].type == FD_CLOSED ? consoleTable[fd] : parentTable[fd];
+        retain(&table[fd]);
+    }
+}
+
+void fdTableRelease(FileDescriptor * table) {
+    for (int fd = 0; fd < PROCESS_MAX_FDS; fd++) {
+        release(&table[fd]);
+    }
+}
+
+// Returns at most one line, like a terminal would
+static int64_t consoleRead(char * buffer, uint64_t count) {
+    uint64_t i = 0;
+    int8_t c;
+    while (i < count && (c = getKeyboardCharacter(AWAIT_RETURN_KEY | SHOW_BUFFER_WHILE_TYPING)) != EOF) {
+        buffer[i++] = c;
+        if (c == '\n') {
+            break;
+        }
+    }
+    return (int64_t) i;
+}
+
+int64_t fdRead(int fd, char * buffer, uint64_t count) {
+    FileDescriptor * descriptor = descriptorOf(fd);
+    if (descriptor == NULL) {
+        return -1;
+    }
+
+    switch (descriptor->type) {
+        case FD_CONSOLE:
+            return consoleRead(buffer, count);
+        case FD_PIPE_READ:
+            return pipeRead(descriptor->target, buffer, count);
+        default:
+            return -1;
+    }
+}
+
+// What was typed so far, up to `count`, without echo
+static int64_t consolePoll(char * buffer, uint64_t count) {
+    uint64_t i = 0;
+    while (i < count && pollKeyboardCharacter((int8_t *) &buffer[i])) {
+        i++;
+    }
+    return i > 0 ? (int64_t) i : FD_WOULD_BLOCK;
+}
+
+static FileDescriptor * descriptorFor(int pid, int fd) {
+    Process * process = isValidPid(pid) && processTable[pid - 1].pid == pid ? &processTable[pid - 1] : NULL;
+    return descriptorIn(getOwnerProcess(process), fd);
+}
+
+int64_t fdReadFor(int pid, int fd, char * buffer, uint64_t count) {
+    FileDescriptor * descriptor = descriptorFor(pid, fd);
+    if (descriptor == NULL || buffer == NULL) {
+        return -1;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    switch (descriptor->type) {
+        case FD_CONSOLE:
+            return consolePoll(buffer, count);
+        case FD_PIPE_READ:
+            return pipeReadable(descriptor->target) ? pipeRead(descriptor->target, buffer, count) : FD_WOULD_BLOCK;
+        default:
+            return -1;
+    }
+}
+
+int64_t fdWrite(int fd, const char * buffer, uint64_t count) {
+    Process * process = currentOwner();
+    return fdWriteFor(process == NULL ? 0 : process->pid, fd, buffer, count);
+}
+
+int64_t fdWriteFor(int pid, int fd, const char * buffer, uint64_t count) {
+    FileDescriptor * descriptor = descriptorFor(pid, fd);
+    if (descriptor == NULL) {
+        return -1;
+    }
+
+    switch (descriptor->type) {
+        case FD_CONSOLE:
+            return printToFd(descriptor->target, buffer, (int32_t) count);
+        case FD_PIPE_WRITE:
+            return pipeWrite(descriptor->target, buffer, count);
+        default:
+            return -1;
+    }
+}
+
+int32_t fdClose(int fd) {
+    Process * process = currentOwner();
+    if (process == NULL || descriptorOf(fd) == NULL) {
+        return -1;
+    }
+    release(&process->fds[fd]);
+    return 0;
+}
+
+static int lowestFreeFd(const Process * process) {
+    for (int fd = 0; fd < PROCESS_MAX_FDS; fd++) {
+        if (process->fds[fd].type == FD_CLOSED) {
+            return fd;
+        }
+    }
+    return -1;
+}
+
+int32_t fdDup(int fd) {
+    Process * process = currentOwner();
+    if (process == NULL || descriptorOf(fd) == NULL) {
+        return -1;
+    }
+
+    int newFd = lowestFreeFd(process);
+    if (newFd < 0) {
+        return -1;
+    }
+    return fdDup2(fd, newFd);
+}
+
+int32_t fdDup2(int fd, int newFd) {
+    Process * process = currentOwner();
+    FileDescriptor * descriptor = descriptorOf(fd);
+    if (process == NULL || descriptor == NULL || newFd < 0 || newFd >= PROCESS_MAX_FDS) {
+        return -1;
+    }
+    if (fd == newFd) {
+        return newFd;
+    }
+
+    // Retained first: closing `newFd` must not drop the last reference to the same pipe end
+    FileDescriptor copy = *descriptor;
+    retain(&copy);
+    release(&process->fds[newFd]);
+    process->fds[newFd] = copy;
+    return newFd;
+}
+
+int32_t fdPipe(int32_t fds[2]) {
+    Process * process = currentOwner();
+    if (process == NULL || fds == NULL) {
+        return -1;
+    }
+
+    int readFd = lowestFreeFd(process);
+    if (readFd < 0) {
+        return -1;
+    }
+    process->fds[readFd].type = FD_PIPE_READ; // reserved so the write end gets another slot
+
+    int writeFd = lowestFreeFd(process);
+    int id = writeFd < 0 ? -1 : pipeCreate();
+    if (id < 0) {
+        process->fds[readFd].type = FD_CLOSED;
+        return -1;
+    }
+
+    process->fds[readFd].target = id;
+    process->fds[writeFd].type = FD_PIPE_WRITE;
+    process->fds[writeFd].target = id;
+    fds[0] = readFd;
+    fds[1] = writeFd;
+    return 0;
+}
@@ -8,6 +8,7 @@
 #include <fonts.h>
 #include <keyboard.h>
 #include <video.h>
+#include <scrollback.h>
 
 /* 
     Note: An attempt was made to use the Linux kernel's Solarize.12x29.psf (https://wiki.osdev.org/PC_Screen_Font). Now only the pain remains.
@@ -70,6 +71,10 @@ uint16_t getXBufferPosition(void) {
     return xBufferPosition;
 }
 
+uint16_t getYBufferPosition(void) {
+    return yBufferPosition;
+}
+
 static char buffer[64] = { '0' };
 
 static inline void renderFromBitmap(char * bitmap, uint64_t xBase, uint64_t yBase);
@@ -113,8 +118,119 @@ static void scrollBufferPositionIfNeeded(void) {
     }
 }
 
+/*
+ * String level text path used by `printToFd`
+ * The string is laid out twice following the same rules as `putChar`: the first pass only tracks positions to learn
+ * how many pixels the screen scrolls, so the scroll happens once per write. The second pass renders every glyph
+ * straight into its final position, skipping lines that would have scrolled out, and emits consecutive glyphs of a
+ * line as a single run (`drawGlyphRun`)
+ */
+
+#define GLYPH_RUN_MAX 256
+
+typedef struct {
+    int64_t x;
+    int64_t y;              // Ignores scrolling, the screen position is `y - scroll`
+    int64_t scrolled;       // Pixels scrolled so far
+    int64_t scroll;         // Render pass: total scroll of the write
+    uint16_t lineHeight;
+    uint16_t stepX;
+    uint16_t stepY;
+    uint16_t windowWidth;
+    uint16_t windowHeight;
+    uint8_t render;
+
+    char run[GLYPH_RUN_MAX];
+    uint64_t runLength;
+    int64_t runX;
+    int64_t runY;
+} TextLayout;
+
+static void layoutBegin(TextLayout * layout, uint8_t render, int64_t scroll) {
+    layout->x = xBufferPosition;
+    layout->y = yBufferPosition;
+    layout->scrolled = 0;
+    layout->scroll = scroll;
+    layout->lineHeight = maxGlyphSizeYOnLine;
+    layout->stepX = glyphSizeX * fontSize;
+    layout->stepY = glyphSizeY * fontSize;
+    layout->windowWidth = getWindowWidth();
+    layout->windowHeight = getWindowHeight();
+    layout->render = render;
+    layout->runLength = 0;
+}
+
+static void layoutFlushRun(TextLayout * layout) {
+    if (layout->runLength == 0) return;
+
+    int64_t y = layout->runY - layout->scroll;
+    if (layout->render && y >= 0) {
+        drawGlyphRun(layout->run, layout->runLength, (const uint8_t *) bitmap, glyphSizeY, layout->runX, y, fontSize, text_color, background_color);
+    }
+    layout->runLength = 0;
+}
+
+// Same as `newLine`
+static void layoutNewLine(TextLayout * layout) {
+    layoutFlushRun(layout);
+    if (layout->render) {
+        scrollbackNewLine(layout->lineHeight, layout->stepY);
+    }
+    layout->y += layout->lineHeight;
+    layout->x = 0;
+    layout->lineHeight = layout->stepY;
+    if (layout->y - layout->scrolled + layout->stepY > layout->windowHeight) {
+        layout->scrolled += layout->stepY;
+    }
+}
+
+static void layoutGlyph(TextLayout * layout, char ascii) {
+    if (layout->x + layout->stepX > layout->windowWidth) {
+        layoutNewLine(layout);
+    }
+
+    // A glyph extends the current run only if it lands right after it, so overwrites keep their order
+    if (layout->runLength == GLYPH_RUN_MAX || (layout->runLength > 0 && (layout->runY != layout->y || layout->runX + (int64_t) (layout->runLength * layout->stepX) != layout->x))) {
+        layoutFlushRun(layout);
+    }
+    if (layout->runLength == 0) {
+        layout->runX = layout->x;
+        layout->runY = layout->y;
+    }
+
+    layout->run[layout->runLength++] = ascii;
+    if (layout->render) {
+        scrollbackPutGlyph(ascii, layout->x, fontSize, text_color, background_color);
+    }
+    layout->x += layout->stepX;
+}
+
+// Mirrors `putChar`, including the cursor being hidden on new lines and carriage returns
+static void layoutChar(TextLayout * layout, char ascii) {
+    switch (ascii) {
+        case NEW_LINE_CHAR:
+            layoutGlyph(layout, ' ');
+            layout->x -= layout->stepX;
+            layoutNewLine(layout);
+            break;
+        case CARRIAGE_RETURN_CHAR:
+            layoutGlyph(layout, ' ');
+            layout->x = 0;
+            break;
+        case TABULATOR_CHAR:
+            do {
+                layoutGlyph(layout, ' ');
+            } while (layout->x % (TAB_SIZE * layout->stepX) != 0);
+            break;
+        default:
+            layoutGlyph(layout, ascii);
+            break;
+    }
+}
+
 // `ascii` ASCII character to print (0-127)
 void putChar(char ascii) {
+    scrollbackFollow();
     dirty_line = 1;
     switch (ascii){
         case NEW_LINE_CHAR:
@@ -138,6 +254,7 @@ void putChar(char ascii) {
             }
 
             renderAscii(ascii, xBufferPosition, yBufferPosition);
+            scrollbackPutGlyph(ascii, xBufferPosition, fontSize, text_color, background_color);
             xBufferPosition += glyphSizeX * fontSize;
             break;
     }
@@ -166,12 +283,60 @@ int32_t printToFd(int32_t fd, const char * string, int32_t count) {
         }
     }
 
-    int i = 0;
-    for ( ; i < count; i++ ) {
-        putChar(string[i]);
+    if (count <= 0) return 0;
+    scrollbackFollow();
+
+    // Layout pass: only figures out how far the screen scrolls during the whole write
+    TextLayout layout;
+    layoutBegin(&layout, 0, 0);
+    for (int32_t i = 0; i < count; i++) {
+        layoutChar(&layout, string[i]);
+    }
+
+    // One scroll for every new line, then the render pass draws straight into the final positions
+    int64_t scroll = layout.scrolled;
+    if (scroll > 0) {
+        scrollVideoMemoryUp(scroll < layout.windowHeight ? scroll : layout.windowHeight, DEFAULT_BACKGROUND_COLOR);
+    }
+
+    layoutBegin(&layout, 1, scroll);
+    for (int32_t i = 0; i < count; i++) {
+        layoutChar(&layout, string[i]);
     }
+    layoutFlushRun(&layout);
+
+    xBufferPosition = layout.x;
+    yBufferPosition = layout.y - scroll;
+    maxGlyphSizeYOnLine = layout.lineHeight;
+    dirty_line = string[count - 1] != NEW_LINE_CHAR;
+
+    return count;
+}
+
+// Renders up to `length` characters at (`x`, `y`) without moving the text cursor
+// Special characters are not interpreted, rendering stops at the right edge of the screen
+void printAt(const char * string, uint64_t length, uint64_t x, uint64_t y, uint32_t color, uint32_t background) {
+    uint32_t previous_text_color = text_color;
+    uint32_t previous_background_color = background_color;
+    uint16_t step = glyphSizeX * fontSize;
+    uint16_t window_width = getWindowWidth();
+
+    if (y + glyphSizeY * fontSize > getWindowHeight()) return;
+
+    text_color = color;
+    background_color = background;
+
+    for (uint64_t i = 0; i < length && string[i] != 0 && x + step <= window_width; i++, x += step) {
+        renderAscii(string[i], x, y);
+    }
+
+    text_color = previous_text_color;
+    background_color = previous_background_color;
+}
 
-    return i;
+// Renders a run of glyphs at (`x`, `y`) with the given font size and colors, used to redraw recorded text
+void drawTextRun(const char * text, uint64_t length, uint64_t x, uint64_t y, uint8_t scale, uint32_t color, uint32_t background) {
+    drawGlyphRun(text, length, (const uint8_t *) bitmap, glyphSizeY, x, y, scale, color, background);
 }
 
 // Prints `string` Null terminated string to `STDOUT`
@@ -181,6 +346,7 @@ void print(const char * string) {
 
 // Jumps to the next line, does not print an empty line
 void newLine(void) {
+    scrollbackNewLine(maxGlyphSizeYOnLine, fontSize * glyphSizeY);
     dirty_line = 0;
     yBufferPosition += maxGlyphSizeYOnLine;
     xBufferPosition = 0;
@@ -204,6 +370,7 @@ void clear(void) {
     fillVideoMemory(DEFAULT_BACKGROUND_COLOR);
     xBufferPosition = 0;
     yBufferPosition = 0;
+    scrollbackClear();
 }
 
 void retractPosition() {
@@ -215,6 +382,7 @@ void retractPosition() {
             yBufferPosition = 0;
             return;
         }
+        scrollbackPreviousLine();
         xBufferPosition = window_width - (window_width % (fontSize * glyphSizeX));
     }
 
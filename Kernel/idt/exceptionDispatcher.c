@@ -2,6 +2,8 @@
 #include <interrupts.h>
 #include <syscallDispatcher.h>
 #include <keyboard.h>
+#include <process.h>
+#include <apic.h>
 
 const static char * register_names[] = {
 	"rax", "rbx", "rcx", "rdx", "rbp", "rdi", "rsi", "r8 ", "r9 ", "r10", "r11", "r12", "r13", "r14", "r15", "rsp", "rip", "rflags"
@@ -12,6 +14,8 @@ const static int registers_amount = sizeof(register_names) / sizeof(*register_na
 #define ZERO_EXCEPTION_ID 0
 #define INVALID_OPCODE_ID 6
 
+#define EXCEPTION_EXIT_CODE 128 // + exception number
+
 static void zero_division(uint64_t * registers, int errorCode);
 static void invalid_opcode(uint64_t * registers, int errorCode);
 
@@ -29,6 +33,15 @@ void exceptionDispatcher(int exception, uint64_t * registers) {
 	}
 }
 
+// A process started by another one exits with EXCEPTION_EXIT_CODE + `exception`, its parent gets the code
+// Returns for the ones the kernel started (the shell), the exception handler restarts them from the top
+void exceptionExit(int exception) {
+	Process * process = getCurrentProcess();
+	if (process != NULL && process->parentPid != 0) {
+		exitCurrentProcess(EXCEPTION_EXIT_CODE + exception);
+	}
+}
+
 static void zero_division(uint64_t * registers, int errorCode) {
 	setTextColor(0x00FF0000);
 	setFontSize(3); print("Division exception\n"); setFontSize(2);
@@ -60,11 +73,17 @@ void printExceptionData(uint64_t * registers, int errorCode) {
 	// getKeyboardCharacter calls _hlt which triggers _sti
 	// so non-keyboard interrupts are disabled until the user confirms
 
-	picMasterMask(KEYBOARD_PIC_MASTER);
-	picSlaveMask(NO_INTERRUPTS);
+	// With the APICs the PIC stays fully masked, unmasking it would deliver every IRQ twice
+	uint8_t usingPic = lapicEOIRegister == 0;
+	if (usingPic) {
+		picMasterMask(KEYBOARD_PIC_MASTER);
+		picSlaveMask(NO_INTERRUPTS);
+	}
 	while ((a = getKeyboardCharacter(0)) != 'r') {}
-	picMasterMask(KEYBOARD_PIC_MASTER & TIMER_PIC_MASTER);
-	picSlaveMask(NO_INTERRUPTS);
+	if (usingPic) {
+		picMasterMask(KEYBOARD_PIC_MASTER & TIMER_PIC_MASTER);
+		picSlaveMask(NO_INTERRUPTS);
+	}
 
 	return ;
 }
\ No newline at end of file
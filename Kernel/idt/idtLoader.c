@@ -1,4 +1,22 @@
 #include <idtLoader.h>
+#include <lib.h>
+#include <apic.h>
+
+// https://wiki.osdev.org/SYSENTER#AMD:_SYSCALL/SYSRET
+#define MSR_EFER   0xC0000080
+#define MSR_STAR   0xC0000081
+#define MSR_LSTAR  0xC0000082
+#define MSR_SFMASK 0xC0000084
+
+#define EFER_SCE 0x01 // System Call Extensions
+
+#define KERNEL_CODE_SELECTOR 0x08
+
+// RFLAGS bits cleared on entry, same as going through an interrupt gate (+ direction flag, as the C ABI expects)
+#define SYSCALL_RFLAGS_MASK (RFLAGS_IF | RFLAGS_TF | RFLAGS_DF)
+#define RFLAGS_TF 0x0100
+#define RFLAGS_IF 0x0200
+#define RFLAGS_DF 0x0400
 
 #pragma pack(push) // save current alignment values into the compilers stack
 #pragma pack(1) // set alignment
@@ -19,6 +37,7 @@ typedef struct {
 DESCR_INT * idt = (DESCR_INT *) 0;
 
 static void setup_IDT_entry(int index, uint64_t offset);
+static void setup_syscall_entry(void);
 
 void load_idt() {
 	_cli();
@@ -30,14 +49,17 @@ void load_idt() {
 	// https://wiki.osdev.org/Interrupts#General_IBM-PC_Compatible_Interrupt_Information
 	setup_IDT_entry(0x20, (uint64_t) &_irq00Handler); 
 	setup_IDT_entry(0x21, (uint64_t) &_irq01Handler);
-	setup_IDT_entry(0x80, (uint64_t) &_irq80Handler);
+	setup_IDT_entry(0x80, (uint64_t) &_irq80Handler); // kept for compatibility, libsys uses SYSCALL
+	setup_IDT_entry(0x81, (uint64_t) &_yieldHandler); // `_yield`, switch without waiting for the tick
+	setup_IDT_entry(APIC_SPURIOUS_VECTOR, (uint64_t) &_spuriousInterruptHandler);
+
+	setup_syscall_entry();
 
 	// Enable:
-	// IRQ0 -> TimerTick
-	// IRQ1 -> Keyboard
-	picMasterMask(KEYBOARD_PIC_MASTER & TIMER_PIC_MASTER);
-	picSlaveMask(NO_INTERRUPTS);
-			
+	// 0x20 -> TimerTick (LAPIC timer, PIT IRQ0 without APICs)
+	// 0x21 -> Keyboard (IOAPIC, PIC IRQ1 without APICs)
+	initApic();
+
 	_sti();
 }
 
@@ -50,3 +72,11 @@ static void setup_IDT_entry(int index, uint64_t offset) {
 	idt[index].offset_h = (offset >> 32) & 0xFFFFFFFF;
 	idt[index].other_zero = 0;
 }
+
+// SYSCALL jumps to LSTAR with CS = STAR[47:32] (and SS = that + 8). The SYSRET selectors (STAR[63:48]) are unused
+static void setup_syscall_entry(void) {
+	writeMSR(MSR_EFER, readMSR(MSR_EFER) | EFER_SCE);
+	writeMSR(MSR_STAR, (uint64_t) KERNEL_CODE_SELECTOR << 32);
+	writeMSR(MSR_LSTAR, (uint64_t) &_syscallHandler);
+	writeMSR(MSR_SFMASK, SYSCALL_RFLAGS_MASK);
+}
@@ -7,80 +7,218 @@
 #include <video.h>
 #include <time.h>
 #include <process.h>
+#include <ioRing.h>
+#include <irqStats.h>
+#include <profiler.h>
+#include <trace.h>
+#include <deferredWork.h>
 #include <MemoryManager.h>
 #include <string.h>
+#include <fileDescriptor.h>
+#include <sharedMemory.h>
+#include <semaphore.h>
+#include <mutex.h>
+#include <messageQueue.h>
+#include <signal.h>
+#include <scheduler.h>
 
 extern int64_t register_snapshot[18];
 extern int64_t register_snapshot_taken;
 
-// @todo Note: Technically.. registers on the stack are modifiable (since its a struct pointer, not struct). 
+typedef int32_t (*SyscallHandler)(uint64_t, uint64_t, uint64_t, uint64_t, uint64_t, uint64_t);
+
+typedef struct {
+	uint64_t id;
+	const char * name;
+	SyscallHandler handler;
+} SyscallDescriptor;
+
+// The handlers must match the parameter lists in `syscall_table.def`, the same ones userland is declared with
+#define SYSCALL(id, name, params) int32_t name params;
+#define LINUX_SYSCALL SYSCALL
+#include <syscall_table.def>
+#undef SYSCALL
+#undef LINUX_SYSCALL
+
+// Dense table built from `syscall_table.def`, the same list the userland stubs are generated from
+enum {
+#define SYSCALL(id, name, params) SYSCALL_INDEX_##name,
+#define LINUX_SYSCALL SYSCALL
+#include <syscall_table.def>
+#undef SYSCALL
+#undef LINUX_SYSCALL
+	SYSCALL_COUNT
+};
+
+static const SyscallDescriptor syscallTable[SYSCALL_COUNT] = {
+#define SYSCALL(id, name, params) [SYSCALL_INDEX_##name] = { (id), #name, (SyscallHandler) name },
+#define LINUX_SYSCALL SYSCALL
+#include <syscall_table.def>
+#undef SYSCALL
+#undef LINUX_SYSCALL
+};
+
+// IDs are sparse: Linux ones are small numbers, custom ones are 0x800000XX. Slots hold the table index + 1, 0 is unused
+#define SYSCALL_SLOTS 0x100
+#define CUSTOM_SYSCALL_BASE 0x80000000
+
+static const uint8_t linuxSyscallSlots[SYSCALL_SLOTS] = {
+#define SYSCALL(id, name, params)
+#define LINUX_SYSCALL(id, name, params) [(id)] = SYSCALL_INDEX_##name + 1,
+#include <syscall_table.def>
+#undef SYSCALL
+#undef LINUX_SYSCALL
+};
+
+static const uint8_t customSyscallSlots[SYSCALL_SLOTS] = {
+#define SYSCALL(id, name, params) [(id) - CUSTOM_SYSCALL_BASE] = SYSCALL_INDEX_##name + 1,
+#define LINUX_SYSCALL(id, name, params)
+#include <syscall_table.def>
+#undef SYSCALL
+#undef LINUX_SYSCALL
+};
+
+static struct {
+	uint64_t calls;
+	uint64_t totalCycles;
+	uint64_t histogram[SYSCALL_HISTOGRAM_BUCKETS];
+} syscallStats[SYSCALL_COUNT];
+
+// Returns the table index, -1 for unknown IDs
+static inline int32_t syscallIndex(uint64_t id) {
+	uint8_t slot = 0;
+	if (id < SYSCALL_SLOTS) {
+		slot = linuxSyscallSlots[id];
+	} else if (id - CUSTOM_SYSCALL_BASE < SYSCALL_SLOTS) {
+		slot = customSyscallSlots[id - CUSTOM_SYSCALL_BASE];
+	}
+	return (int32_t) slot - 1;
+}
+
+static inline void recordSyscall(int32_t index, uint64_t cycles) {
+	uint8_t bucket = cycles == 0 ? 0 : 63 - __builtin_clzll(cycles);
+	if (bucket >= SYSCALL_HISTOGRAM_BUCKETS) bucket = SYSCALL_HISTOGRAM_BUCKETS - 1;
+
+	syscallStats[index].calls++;
+	syscallStats[index].totalCycles += cycles;
+	syscallStats[index].histogram[bucket]++;
+}
+
+// Handlers are called with the 6 argument registers, each one takes the ones it needs
+// Note: Register parameters are 64-bit
 int32_t syscallDispatcher(Registers * registers) {
-	switch(registers->rax){
-		case 3: return sys_read(registers->rdi, (signed char *) registers->rsi, registers->rdx);
-		// Note: Register parameters are 64-bit
-		case 4: return sys_write(registers->rdi, (char *) registers->rsi, registers->rdx);
-		
-		case 0x80000000: return sys_start_beep(registers->rdi);
-		case 0x80000001: return sys_stop_beep();
-		case 0x80000002: return sys_fonts_text_color(registers->rdi);
-		case 0x80000003: return sys_fonts_background_color(registers->rdi);
-		case 0x80000004: /* Reserved for sys_set_italics */
-		case 0x80000005: /* Reserved for sys_set_bold */
-		case 0x80000006: /* Reserved for sys_set_underline */
-			return -1;
-		case 0x80000007: return sys_fonts_decrease_size();
-		case 0x80000008: return sys_fonts_increase_size();
-		case 0x80000009: return sys_fonts_set_size((uint8_t) registers->rdi);
-		case 0x8000000A: return sys_clear_screen();
-		case 0x8000000B: return sys_clear_input_buffer();
-
-		case 0x80000010: return sys_hour((int *) registers->rdi);
-		case 0x80000011: return sys_minute((int *) registers->rdi);
-		case 0x80000012: return sys_second((int *) registers->rdi);
-
-		case 0x80000019: return sys_circle(registers->rdi, registers->rsi, registers->rdx, registers->rcx);
-		case 0x80000020: return sys_rectangle(registers->rdi, registers->rsi, registers->rdx, registers->rcx, registers->r8);
-		case 0x80000021: return sys_fill_video_memory(registers->rdi);
-
-		case 0x800000A0: return sys_exec((int (*)(void)) registers->rdi);
-
-		case 0x800000B0: return sys_register_key((uint8_t) registers->rdi, (SpecialKeyHandler) registers->rsi);
-		case 0x800000B1: return sys_register_ctrl_key((uint8_t) registers->rdi, (SpecialKeyHandler) registers->rsi);
-
-		case 0x800000C0: return sys_window_width();
-		case 0x800000C1: return sys_window_height();
-
-		case 0x800000D0: return sys_sleep_milis(registers->rdi);
-
-		case 0x800000E0: return sys_get_register_snapshot((int64_t *) registers->rdi);
-
-		case 0x800000F0: return sys_get_character_without_display();
-		case 0x800000F1: return sys_get_processes((ProcessInfo *) registers->rdi, registers->rsi);
-		case 0x800000F2: return sys_kill_process((int32_t)registers->rdi);
-		case 0x800000F3: return sys_toggle_block_process((int32_t)registers->rdi);
-		case 0x800000F4: return sys_get_memory_state((char *)registers->rdi, registers->rsi);
-		case 0x800000F5: return sys_set_process_priority((int32_t)registers->rdi, (int32_t)registers->rsi);
-		
-		default:
-            return 0;
+	int32_t index = syscallIndex(registers->rax);
+	if (index < 0) {
+		return -1;
+	}
+
+	TRACE(TRACE_SYSCALL_ENTER, registers->rax, registers->rdi);
+	uint64_t start = readTSC();
+	int32_t result = syscallTable[index].handler(registers->rdi, registers->rsi, registers->rdx, registers->rcx, registers->r8, registers->r9);
+	recordSyscall(index, readTSC() - start);
+	TRACE(TRACE_SYSCALL_EXIT, registers->rax, (int64_t) result);
+
+	return result;
+}
+
+int32_t sys_get_syscall_stats(SyscallStats * userBuffer, uint64_t capacity) {
+	if (userBuffer == NULL) {
+		return -1;
+	}
+
+	uint64_t count = capacity < SYSCALL_COUNT ? capacity : SYSCALL_COUNT;
+	for (uint64_t i = 0; i < count; i++) {
+		SyscallStats * entry = &userBuffer[i];
+		entry->id = syscallTable[i].id;
+		uint64_t len = 0;
+		for (; syscallTable[i].name[len] != 0 && len + 1 < SYSCALL_NAME_LENGTH; len++) {
+			entry->name[len] = syscallTable[i].name[len];
+		}
+		entry->name[len] = 0;
+		entry->calls = syscallStats[i].calls;
+		entry->totalCycles = syscallStats[i].totalCycles;
+		memcpy(entry->histogram, syscallStats[i].histogram, sizeof(entry->histogram));
+	}
+
+	return (int32_t) count;
+}
+
+int32_t sys_get_irq_stats(IrqStats * userBuffer, uint64_t capacity) {
+	if (userBuffer == NULL) {
+		return -1;
+	}
+	return (int32_t) getIrqStats(userBuffer, capacity > IRQ_SOURCE_COUNT ? IRQ_SOURCE_COUNT : (uint32_t) capacity);
+}
+
+int32_t sys_profiler_control(uint64_t enable) {
+	if (enable) {
+		profilerStart();
+	} else {
+		profilerStop();
+	}
+	return 0;
+}
+
+int32_t sys_profiler_read(ProfileSample * userBuffer, uint64_t capacity) {
+	if (userBuffer == NULL) {
+		return -1;
+	}
+	return (int32_t) profilerRead(userBuffer, capacity > PROFILER_MAX_SAMPLES ? PROFILER_MAX_SAMPLES : (uint32_t) capacity);
+}
+
+int32_t sys_get_symbol_table(const char ** table) {
+	if (table == NULL) {
+		return -1;
 	}
+	return (int32_t) getSymbolTable(table);
+}
+
+int32_t sys_trace_control(uint64_t enable) {
+	return traceSetEnabled(enable != 0);
+}
+
+int32_t sys_trace_read(TraceEvent * userBuffer, uint64_t capacity, uint64_t * cursor) {
+	if (userBuffer == NULL || cursor == NULL) {
+		return -1;
+	}
+	return (int32_t) traceRead(userBuffer, capacity > TRACE_BUFFER_ENTRIES ? TRACE_BUFFER_ENTRIES : (uint32_t) capacity, cursor);
 }
 
 // ==================================================================
 // Linux syscalls
 // ==================================================================
 
-int32_t sys_write(int32_t fd, char * __user_buf, int32_t count) {
-    return printToFd(fd, __user_buf, count);
+int32_t sys_exit(int32_t exitCode) {
+	exitCurrentProcess(exitCode);
+	return 0;
 }
 
-int32_t sys_read(int32_t fd, signed char * __user_buf, int32_t count) {
-	int32_t i;
-	int8_t c;
-	for(i = 0; i < count && (c = getKeyboardCharacter(AWAIT_RETURN_KEY | SHOW_BUFFER_WHILE_TYPING)) != EOF; i++){
-		*(__user_buf + i) = c;
-	}
-    return i;
+int32_t sys_waitpid(int32_t pid, int32_t * exitCode, int32_t options) {
+	return waitProcess(pid, exitCode, options);
+}
+
+int32_t sys_write(int32_t fd, const void * buffer, int32_t count) {
+    return (int32_t) fdWrite(fd, buffer, count < 0 ? 0 : (uint64_t) count);
+}
+
+int32_t sys_read(int32_t fd, void * buffer, int32_t count) {
+    return (int32_t) fdRead(fd, buffer, count < 0 ? 0 : (uint64_t) count);
+}
+
+int32_t sys_close(int32_t fd) {
+    return fdClose(fd);
+}
+
+int32_t sys_dup(int32_t fd) {
+    return fdDup(fd);
+}
+
+int32_t sys_dup2(int32_t fd, int32_t newFd) {
+    return fdDup2(fd, newFd);
+}
+
+int32_t sys_pipe(int32_t * fds) {
+    return fdPipe(fds);
 }
 
 // ==================================================================
@@ -129,11 +267,11 @@ int32_t sys_clear_input_buffer(void) {
 	return 0;
 }
 
-uint16_t sys_window_width(void) {
+int32_t sys_window_width(void) {
 	return getWindowWidth();
 }
 
-uint16_t sys_window_height(void) {
+int32_t sys_window_height(void) {
 	return getWindowHeight();
 }
 
@@ -153,7 +291,12 @@ int32_t sys_get_processes(ProcessInfo *userBuffer, uint64_t capacity) {
 }
 
 int32_t sys_kill_process(int32_t pid) {
-	return killProcess(pid);
+	int32_t result = killProcess(pid);
+	// From a key handler (deferred work) the killed process may be the interrupted one: it is switched away on the next tick
+	if (result == 0 && pid == getCurrentPid() && !deferredWorkIsRunning()) {
+		exitCurrentProcess(PROCESS_KILLED_EXIT_CODE); // already a zombie, only waits to be switched away
+	}
+	return result;
 }
 
 int32_t sys_toggle_block_process(int32_t pid) {
@@ -187,6 +330,27 @@ int32_t sys_set_process_priority(int32_t pid, int32_t priority) {
 	return setProcessPriority(pid, priority);
 }
 
+int32_t sys_create_process(void * entry, char ** argv, uint64_t argc, int32_t priority, uint64_t foreground) {
+	if (entry == NULL || argv == NULL || argc == 0 || priority < PROCESS_PRIORITY_MIN || priority > PROCESS_PRIORITY_MAX) {
+		return -1;
+	}
+
+	Process * process = createProcess(argv[0], (void (*)(void *)) entry, argv, (int) argc, NULL, 0, foreground != 0);
+	if (process == NULL) {
+		return -1;
+	}
+
+	setProcessPriority(process->pid, priority);
+	return process->pid;
+}
+
+int32_t sys_yield(void) {
+	if (!deferredWorkIsRunning()) {
+		schedulerOnYield();
+	}
+	return 0;
+}
+
 // ==================================================================
 // Date system calls
 // ==================================================================
@@ -206,6 +370,14 @@ int32_t sys_second(int * second) {
 	return 0;
 }
 
+int32_t sys_get_kernel_data(const KernelData ** data) {
+	if (data == NULL) {
+		return -1;
+	}
+	*data = getKernelData();
+	return 0;
+}
+
 // ==================================================================
 // Draw system calls
 // ==================================================================
@@ -216,7 +388,12 @@ int32_t sys_circle(uint32_t hexColor, uint64_t topLeftX, uint64_t topLeftY, uint
 	return 0;
 }
 
-int32_t sys_rectangle(uint32_t color, uint64_t width_pixels, uint64_t height_pixels, uint64_t initial_pos_x, uint64_t initial_pos_y){
+int32_t sys_ellipse(uint32_t hexColor, int64_t topLeftX, int64_t topLeftY, uint64_t width, uint64_t height, uint32_t flags) {
+	drawEllipse(hexColor, topLeftX, topLeftY, width, height, flags & DRAW_OUTLINE);
+	return 0;
+}
+
+int32_t sys_rectangle(uint32_t color, uint64_t width_pixels, uint64_t height_pixels, int64_t initial_pos_x, int64_t initial_pos_y){
 	drawRectangle(color, width_pixels, height_pixels, initial_pos_x, initial_pos_y);
 	return 0;
 }
@@ -226,11 +403,202 @@ int32_t sys_fill_video_memory(uint32_t hexColor) {
 	return 0;
 }
 
+int32_t sys_draw_batch(const DrawCommand * commands, uint64_t count) {
+	if (commands == NULL) {
+		return -1;
+	}
+
+	if (count > DRAW_BATCH_MAX_COMMANDS) {
+		count = DRAW_BATCH_MAX_COMMANDS;
+	}
+
+	uint64_t i = 0;
+	for (; i < count; i++) {
+		const DrawCommand * cmd = &commands[i];
+		switch (cmd->type) {
+			case DRAW_CMD_RECTANGLE:
+				drawRectangle(cmd->color, cmd->args.rectangle.width, cmd->args.rectangle.height, cmd->x, cmd->y);
+				break;
+			case DRAW_CMD_CIRCLE:
+				drawEllipse(cmd->color, cmd->x, cmd->y, cmd->args.circle.diameter, cmd->args.circle.diameter, cmd->args.circle.flags & DRAW_OUTLINE);
+				break;
+			case DRAW_CMD_ELLIPSE:
+				drawEllipse(cmd->color, cmd->x, cmd->y, cmd->args.ellipse.width, cmd->args.ellipse.height, cmd->args.ellipse.flags & DRAW_OUTLINE);
+				break;
+			case DRAW_CMD_LINE:
+				drawLine(cmd->color, cmd->x, cmd->y, cmd->args.line.x1, cmd->args.line.y1);
+				break;
+			case DRAW_CMD_BLIT:
+				if (cmd->args.blit.pixels != NULL) {
+					drawBitmap(cmd->args.blit.pixels, cmd->args.blit.width, cmd->args.blit.height, cmd->x, cmd->y);
+				}
+				break;
+			case DRAW_CMD_TEXT:
+				if (cmd->args.text.text != NULL) {
+					printAt(cmd->args.text.text, cmd->args.text.length, cmd->x, cmd->y, cmd->color, cmd->args.text.backgroundColor);
+				}
+				break;
+			case DRAW_CMD_FILL:
+				fillVideoMemory(cmd->color);
+				break;
+			case DRAW_CMD_BLIT_REQUEST:
+				blitBitmap(cmd->args.blitRequest.request, cmd->x, cmd->y);
+				break;
+			default:
+				return (int32_t) i; // stop at the first unknown command, report how many were executed
+		}
+	}
+
+	return (int32_t) i;
+}
+
+int32_t sys_blit(const BlitRequest * request, int64_t x, int64_t y) {
+	return blitBitmap(request, x, y);
+}
+
+// ==================================================================
+// Submission/completion ring system calls
+// ==================================================================
+
+int32_t sys_io_ring_setup(IoRing * ring) {
+	return ioRingSetup(getCurrentPid(), ring);
+}
+
+int32_t sys_io_ring_enter(uint32_t toSubmit, uint32_t minComplete) {
+	return ioRingEnter(getCurrentPid(), toSubmit, minComplete);
+}
+
+int32_t sys_shm_open(const char * name, uint64_t size, void ** address) {
+	return sharedMemoryOpen(getCurrentPid(), name, size, address);
+}
+
+int32_t sys_shm_attach(int32_t id, void ** address) {
+	return sharedMemoryAttach(getCurrentPid(), id, address);
+}
+
+int32_t sys_shm_detach(int32_t id) {
+	return sharedMemoryDetach(getCurrentPid(), id);
+}
+
+int32_t sys_sem_open(const char * name, int32_t value, volatile int32_t ** counter) {
+	return semaphoreOpen(getCurrentPid(), name, value, counter);
+}
+
+int32_t sys_sem_attach(int32_t id, volatile int32_t ** counter) {
+	return semaphoreAttach(getCurrentPid(), id, counter);
+}
+
+int32_t sys_sem_wait(int32_t id) {
+	if (deferredWorkIsRunning()) {
+		return -1;
+	}
+	return semaphoreWait(getCurrentPid(), id);
+}
+
+int32_t sys_sem_post(int32_t id) {
+	return semaphorePost(getCurrentPid(), id);
+}
+
+int32_t sys_sem_close(int32_t id) {
+	return semaphoreClose(getCurrentPid(), id);
+}
+
+int32_t sys_mutex_open(const char * name) {
+	return mutexOpen(getCurrentPid(), name);
+}
+
+int32_t sys_mutex_attach(int32_t id) {
+	return mutexAttach(getCurrentPid(), id);
+}
+
+int32_t sys_mutex_lock(int32_t id) {
+	if (deferredWorkIsRunning()) {
+		return -1;
+	}
+	return mutexLock(getCurrentPid(), id);
+}
+
+int32_t sys_mutex_unlock(int32_t id) {
+	return mutexUnlock(getCurrentPid(), id);
+}
+
+int32_t sys_mutex_close(int32_t id) {
+	return mutexClose(getCurrentPid(), id);
+}
+
+int32_t sys_mq_open(const char * name, uint32_t messageSize, uint32_t capacity) {
+	return messageQueueOpen(getCurrentPid(), name, messageSize, capacity);
+}
+
+int32_t sys_mq_attach(int32_t id) {
+	return messageQueueAttach(getCurrentPid(), id);
+}
+
+int32_t sys_mq_sendv(int32_t id, const void * messages, uint32_t count, uint32_t flags) {
+	return messageQueueSend(getCurrentPid(), id, messages, count, flags);
+}
+
+int32_t sys_mq_recvv(int32_t id, void * messages, uint32_t capacity, uint32_t flags) {
+	return messageQueueReceive(getCurrentPid(), id, messages, capacity, flags);
+}
+
+int32_t sys_mq_stats(int32_t id, MessageQueueStats * stats) {
+	return messageQueueStats(getCurrentPid(), id, stats);
+}
+
+int32_t sys_mq_close(int32_t id) {
+	return messageQueueClose(getCurrentPid(), id);
+}
+
+int32_t sys_signal_send(int32_t pid, int32_t signal) {
+	return signalSend(pid, signal);
+}
+
+int32_t sys_signal_handler(int32_t signal, SignalHandler handler, SignalHandler * previous) {
+	return signalSetHandler(getCurrentPid(), signal, handler, previous);
+}
+
+int32_t sys_signal_mask(uint32_t mask, uint32_t * previous) {
+	return signalSetMask(getCurrentPid(), mask, previous);
+}
+
+int32_t sys_set_process_group(int32_t pid, int32_t group) {
+	return setProcessGroup(pid, group);
+}
+
+int32_t sys_set_foreground_group(int32_t group) {
+	signalSetForegroundGroup(group);
+	return 0;
+}
+
+int32_t sys_thread_create(int32_t (*entry)(void *), void * arg) {
+	Process * thread = createThread((int (*)(void *)) entry, arg);
+	return thread == NULL ? -1 : thread->pid;
+}
+
+int32_t sys_thread_join(int32_t tid, int32_t * exitCode) {
+	if (deferredWorkIsRunning()) {
+		return -1;
+	}
+	return joinThread(tid, exitCode);
+}
+
 // ==================================================================
 // Custom exec system call
 // ==================================================================
 
+// Runs `fnPtr` as a foreground child process and waits for it, so it does not run inside the system call
 int32_t sys_exec(int32_t (*fnPtr)(void)) {
+	if (fnPtr == NULL) {
+		return -1;
+	}
+
+	char * argv[] = { "exec" };
+	Process * process = createProcess(argv[0], (void (*)(void *)) fnPtr, argv, 1, NULL, 0, FOREGROUND);
+	if (process == NULL) {
+		return -1;
+	}
+
 	clear();
 
 	uint8_t fontSize = getFontSize(); 					// preserve font size
@@ -242,7 +610,8 @@ int32_t sys_exec(int32_t (*fnPtr)(void)) {
 	clearKeyFnMapNonKernel(map); // avoid """processes/threads/apps""" registering keys across each other over time. reset the map every time
 	clearControlKeyFnMapNonKernel(controlMap);
 	
-	int32_t aux = fnPtr();
+	int aux = -1;
+	waitProcess(process->pid, &aux, 0);
 
 	restoreKeyFnMapNonKernel(map);
 	restoreControlKeyFnMapNonKernel(controlMap);
@@ -291,6 +660,11 @@ int32_t sys_get_register_snapshot(int64_t * registers) {
 	return 1;
 }
 
+// Does nothing, measures the cost of entering and leaving the kernel
+int32_t sys_nop(void) {
+	return 0;
+}
+
 int32_t sys_get_character_without_display(void) {
 	return getKeyboardCharacter(0);
 }
@@ -0,0 +1,23 @@
+#ifndef APIC_H
+#define APIC_H
+
+#include <stdint.h>
+
+// Interrupt delivery through the Local APIC and the IOAPIC, replacing the 8259 PIC
+// Pure64 finds both controllers in the ACPI MADT and leaves their addresses in its system variables
+// https://wiki.osdev.org/APIC, https://wiki.osdev.org/IOAPIC
+
+#define APIC_TIMER_VECTOR 0x20      // same vectors the PIC used, handlers do not change
+#define APIC_KEYBOARD_VECTOR 0x21
+#define APIC_SPURIOUS_VECTOR 0xFF
+
+#define ISA_IRQ_KEYBOARD 1
+
+// Address of the LAPIC EOI register, 0 while the PIC is still in use. Read by the IRQ handlers (`interrupts.asm`)
+extern volatile uint32_t * lapicEOIRegister;
+
+// Masks the PIC, routes the keyboard through the IOAPIC and starts the LAPIC timer with the
+// current tick period. Falls back to the PIC if Pure64 did not find the APICs. Returns 1 when the APICs are in use
+uint8_t initApic(void);
+
+#endif
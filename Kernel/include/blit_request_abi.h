@@ -0,0 +1,32 @@
+#ifndef BLIT_REQUEST_ABI_H
+#define BLIT_REQUEST_ABI_H
+
+#include <stdint.h>
+
+// Shared between the kernel and userland (see `sys_blit`)
+
+typedef enum {
+    BITMAP_FORMAT_ARGB32 = 0,   // one uint32_t 0xAARRGGBB per pixel, alpha is ignored
+    BITMAP_FORMAT_INDEXED8,     // one uint8_t per pixel, looked up in `palette` (256 entries)
+} BitmapFormat;
+
+#define BLIT_COLOR_KEY  0x01    // skip source pixels equal to `colorKey` (an RGB value or a palette index)
+#define BLIT_CLIP       0x02    // restrict drawing to the clip rectangle, on top of the screen bounds
+
+typedef struct {
+    const void * pixels;
+    const uint32_t * palette;   // BITMAP_FORMAT_INDEXED8 only
+    uint32_t format;            // BitmapFormat
+    uint32_t flags;             // BLIT_* flags
+    uint32_t width;             // in source pixels
+    uint32_t height;
+    uint32_t stride;            // source pixels per row, 0 means `width`
+    uint32_t scale;             // integer scaling factor, 0 means 1
+    uint32_t colorKey;
+    int32_t clipX;              // screen coordinates, used with BLIT_CLIP
+    int32_t clipY;
+    uint32_t clipWidth;
+    uint32_t clipHeight;
+} BlitRequest;
+
+#endif // BLIT_REQUEST_ABI_H
@@ -0,0 +1,23 @@
+#ifndef DEFERRED_WORK_H
+#define DEFERRED_WORK_H
+
+#include <stdint.h>
+
+// Bottom halves: interrupt handlers only capture the event and queue the work that follows from it
+// The queue is run on the way out of the IRQ (see `interrupts.asm`), with interrupts enabled, in order
+
+#define DEFERRED_WORK_QUEUE_SIZE 128 // power of two
+
+typedef void (*DeferredWork)(uint64_t arg);
+
+// Interrupts must be disabled (IRQ context). Returns 0 if the queue is full and the work was dropped
+uint8_t queueDeferredWork(DeferredWork work, uint64_t arg);
+
+// Called with interrupts disabled, returns with interrupts disabled. Does nothing when already running
+void runDeferredWork(void);
+
+// The scheduler does not switch processes while the queue is being run
+// Work runs on behalf of whatever process was interrupted, so nothing it calls blocks: blocking paths check this and return early
+uint8_t deferredWorkIsRunning(void);
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef DRAW_COMMAND_ABI_H
+#define DRAW_COMMAND_ABI_H
+
+#include <stdint.h>
+#include <blit_request_abi.h>
+
+// Shared between the kernel and userland (see `sys_draw_batch`)
+// A whole frame is described as an array of `DrawCommand` and executed in a single kernel entry
+
+#define DRAW_BATCH_MAX_COMMANDS 1024
+
+#define DRAW_OUTLINE 0x01 // circles and ellipses: draw only the border
+
+typedef enum {
+    DRAW_CMD_RECTANGLE = 0,
+    DRAW_CMD_CIRCLE,
+    DRAW_CMD_LINE,
+    DRAW_CMD_BLIT,
+    DRAW_CMD_TEXT,
+    DRAW_CMD_FILL,
+    DRAW_CMD_BLIT_REQUEST,
+    DRAW_CMD_ELLIPSE,
+} DrawCommandType;
+
+typedef struct {
+    uint32_t type;      // DrawCommandType
+    uint32_t color;     // 0x00RRGGBB, ignored by DRAW_CMD_BLIT
+    int64_t x;          // top left corner (or first point for DRAW_CMD_LINE)
+    int64_t y;
+    union {
+        struct { uint64_t width; uint64_t height; } rectangle;
+        struct { uint64_t diameter; uint32_t flags; } circle;
+        struct { uint64_t width; uint64_t height; uint32_t flags; } ellipse; // bounding box
+        struct { int64_t x1; int64_t y1; } line;
+        struct { const uint32_t * pixels; uint64_t width; uint64_t height; } blit; // 0x00RRGGBB pixels, row major
+        struct { const char * text; uint64_t length; uint32_t backgroundColor; } text;
+        struct { const BlitRequest * request; } blitRequest; // palette, color key, clipping and scaling
+    } args;
+} DrawCommand;
+
+#endif // DRAW_COMMAND_ABI_H
@@ -0,0 +1,51 @@
+#ifndef FILE_DESCRIPTOR_H
+#define FILE_DESCRIPTOR_H
+
+#include <stdint.h>
+
+// Per process descriptor tables. `sys_read` and `sys_write` go through the caller's table (its process' one for threads)
+// 0, 1 and 2 start on the console (keyboard, stdout and stderr colors), `sys_pipe` adds pipe ends
+
+#define PROCESS_MAX_FDS 16
+
+#define CONSOLE_STDIN 0
+#define CONSOLE_STDOUT 1
+#define CONSOLE_STDERR 2
+
+#define FD_WOULD_BLOCK -2
+
+typedef enum {
+    FD_CLOSED = 0,
+    FD_CONSOLE,     // target: console stream (CONSOLE_*)
+    FD_PIPE_READ,   // target: pipe id
+    FD_PIPE_WRITE,
+} FileDescriptorType;
+
+typedef struct {
+    uint8_t type;   // FileDescriptorType
+    int32_t target;
+} FileDescriptor;
+
+// Tables of new processes: a copy of the parent's standard descriptors (0 to 2), the console if there is no parent
+void fdTableInit(FileDescriptor * table, const FileDescriptor * parentTable);
+
+// Closes every descriptor, pipe ends included (readers see end of file once no writer is left)
+void fdTableRelease(FileDescriptor * table);
+
+// The following act on the current process' table, they return -1 for invalid descriptors
+// From deferred work reads and writes go to the console and the rest fail
+int64_t fdRead(int fd, char * buffer, uint64_t count);
+int64_t fdWrite(int fd, const char * buffer, uint64_t count);
+
+// Read and write through the table of `pid` (its process' one for threads), whoever is running: work done on its behalf
+// from the timer tick. The read never blocks, it returns FD_WOULD_BLOCK while there is nothing to read yet
+int64_t fdReadFor(int pid, int fd, char * buffer, uint64_t count);
+int64_t fdWriteFor(int pid, int fd, const char * buffer, uint64_t count);
+int32_t fdClose(int fd);
+int32_t fdDup(int fd);
+int32_t fdDup2(int fd, int newFd);
+
+// Stores the read end in fds[0] and the write end in fds[1]
+int32_t fdPipe(int32_t fds[2]);
+
+#endif // FILE_DESCRIPTOR_H
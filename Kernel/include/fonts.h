@@ -20,6 +20,8 @@
 void putChar(char ascii);
 void print(const char * string);
 int32_t printToFd(int32_t fd, const char * string, int32_t count);
+void printAt(const char * string, uint64_t length, uint64_t x, uint64_t y, uint32_t color, uint32_t background);
+void drawTextRun(const char * text, uint64_t length, uint64_t x, uint64_t y, uint8_t scale, uint32_t color, uint32_t background);
 void newLine();
 void printDec(uint64_t value);
 void printHex(uint64_t value);
@@ -31,6 +33,7 @@ void hideCursor(void);
 void retractPosition();
 void clearPreviousCharacter(void);
 uint16_t getXBufferPosition(void);
+uint16_t getYBufferPosition(void);
 
 uint8_t increaseFontSize(void);
 uint8_t decreaseFontSize(void);
@@ -11,6 +11,9 @@
 extern void (*_irq00Handler) (void);
 extern void (*_irq01Handler) (void);
 extern void (*_irq80Handler) (void);
+extern void (*_yieldHandler) (void);
+extern void (*_syscallHandler) (void);
+extern void (*_spuriousInterruptHandler) (void);
 
 extern void (*_exceptionHandler00) (void);
 extern void (*_exceptionHandler06) (void);
@@ -27,6 +30,8 @@ void picSlaveMask(uint8_t mask);
 
 void contextSwitch(void);
 
+void _yield(void);
+
 #define TIMER_PIC_MASTER 0xFE
 #define KEYBOARD_PIC_MASTER 0xFD
 #define NO_INTERRUPTS 0xFF
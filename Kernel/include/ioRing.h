@@ -0,0 +1,25 @@
+#ifndef IO_RING_H
+#define IO_RING_H
+
+#include <stdint.h>
+#include <io_ring_abi.h>
+
+// Submission/completion rings, one per process (see `io_ring_abi.h` for the shared layout)
+// Writes, draws and process operations complete during submission, sleeps and reads stay pending
+// and are completed from the timer tick
+
+#define IO_RING_MAX_PENDING 64 // sleeps and reads waiting across all processes
+
+int32_t ioRingSetup(int pid, IoRing * ring);
+
+// Consumes up to `toSubmit` submissions, then waits until `minComplete` completions are ready
+// (or nothing is left in flight). Returns the submissions consumed, -1 if `pid` has no ring
+int32_t ioRingEnter(int pid, uint32_t toSubmit, uint32_t minComplete);
+
+// Called by the timer handler: completes due sleeps and ready reads, drains IO_RING_DRAIN_ON_TICK rings
+void ioRingOnTick(void);
+
+// Drops the ring and the pending operations of a process that is going away
+void ioRingRelease(int pid);
+
+#endif
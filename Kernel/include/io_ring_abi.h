@@ -0,0 +1,50 @@
+#ifndef IO_RING_ABI_H
+#define IO_RING_ABI_H
+
+#include <stdint.h>
+
+// Shared between the kernel and userland (see `sys_io_ring_setup` and `sys_io_ring_enter`)
+// A process registers one `IoRing` it owns. It queues operations in the submission ring and hands
+// many of them to the kernel with a single `sys_io_ring_enter`, results are posted to the completion ring
+// Indices are free running, the slot is `index % ENTRIES`. Each side only writes its own index
+
+#define IO_RING_ENTRIES 64                                  // power of two
+#define IO_RING_COMPLETION_ENTRIES (IO_RING_ENTRIES * 2)    // power of two
+
+#define IO_RING_DRAIN_ON_TICK 0x01 // setup flag: the kernel also consumes submissions on every timer tick
+
+typedef enum {
+    IO_OP_NOP = 0,
+    IO_OP_WRITE,            // fd, address: buffer, length: bytes. Completes with the bytes written
+    IO_OP_READ,             // fd, address: buffer, length: bytes. Completes once something can be read (console input is not echoed)
+    IO_OP_SLEEP,            // length: milliseconds. Completes with 0 when the time is up
+    IO_OP_DRAW,             // address: `DrawCommand` array, length: commands. Completes with the commands executed
+    IO_OP_KILL,             // fd: pid
+    IO_OP_SET_PRIORITY,     // fd: pid, length: priority
+    IO_OP_TOGGLE_BLOCK,     // fd: pid
+} IoOpcode;
+
+typedef struct {
+    uint32_t opcode;        // IoOpcode
+    int32_t fd;             // file descriptor, or pid for process operations
+    uint64_t address;
+    uint64_t length;
+    uint64_t userData;      // copied as is into the completion
+} IoSubmission;
+
+typedef struct {
+    uint64_t userData;
+    int64_t result;         // -1 for malformed or failed operations
+} IoCompletion;
+
+typedef struct {
+    volatile uint32_t submissionHead;   // advanced by the kernel
+    volatile uint32_t submissionTail;   // advanced by userland, after the entry is written
+    volatile uint32_t completionHead;   // advanced by userland
+    volatile uint32_t completionTail;   // advanced by the kernel, after the entry is written
+    uint32_t flags;
+    IoSubmission submissions[IO_RING_ENTRIES];
+    IoCompletion completions[IO_RING_COMPLETION_ENTRIES];
+} IoRing;
+
+#endif // IO_RING_ABI_H
@@ -0,0 +1,23 @@
+#ifndef IRQ_STATS_H
+#define IRQ_STATS_H
+
+#include <stdint.h>
+#include <irq_stats_abi.h>
+
+// Called by the IRQ handlers (`interrupts.asm`) right after saving state and right after the EOI
+void irqEnter(uint32_t source);
+void irqExit(uint32_t source);
+
+// Called by the system call entries, which can block and switch away before returning
+// They keep the TSC read on entry in their own frame instead of going through `irqEnter`
+void irqExitSince(uint32_t source, uint64_t since);
+
+// Called by `_sti` with the TSC stamped by the `_cli` that opened the masked section
+void recordMaskedSection(uint64_t since);
+
+void recordIrqCycles(uint32_t source, uint64_t cycles);
+
+// Fills up to `capacity` entries, one per source, returns how many were written
+uint32_t getIrqStats(IrqStats * buffer, uint32_t capacity);
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef IRQ_STATS_ABI_H
+#define IRQ_STATS_ABI_H
+
+#include <stdint.h>
+
+// Shared between the kernel and userland (see `sys_get_irq_stats`)
+// Interrupt latency, in TSC cycles: how long each handler runs and how long interrupts stay masked
+
+#define IRQ_STATS_NAME_LENGTH 16
+#define IRQ_HISTOGRAM_BUCKETS 32
+
+// Also used by `interrupts.asm`, keep the values in sync
+#define IRQ_SOURCE_TIMER 0          // `_irq00Handler`, up to the EOI (the bottom half is counted apart)
+#define IRQ_SOURCE_KEYBOARD 1       // `_irq01Handler`, up to the EOI
+#define IRQ_SOURCE_INT80 2          // `_irq80Handler`, the whole system call
+#define IRQ_SOURCE_SYSCALL 3        // `_syscallHandler`, the whole system call
+#define IRQ_SOURCE_DEFERRED 4       // each deferred work item (runs with interrupts enabled)
+#define IRQ_SOURCE_MASKED 5         // `_cli` to `_sti`
+#define IRQ_SOURCE_COUNT 6
+
+typedef struct {
+    char name[IRQ_STATS_NAME_LENGTH];
+    uint64_t count;
+    uint64_t totalCycles;
+    uint64_t maxCycles;
+    // `histogram[i]`: events that took [2^i, 2^(i+1)) TSC cycles, the last bucket also holds anything slower
+    uint64_t histogram[IRQ_HISTOGRAM_BUCKETS];
+} IrqStats;
+
+#endif // IRQ_STATS_ABI_H
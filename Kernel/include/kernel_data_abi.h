@@ -0,0 +1,34 @@
+#ifndef KERNEL_DATA_ABI_H
+#define KERNEL_DATA_ABI_H
+
+#include <stdint.h>
+
+// Shared between the kernel and userland (see `sys_get_kernel_data`)
+// A page the kernel updates on every timer tick, userland only reads it, no system call involved
+// Readers follow the seqlock protocol: `sequence` is odd while the kernel is writing, a read is valid
+// only if `sequence` was even and did not change while the rest of the fields were copied
+
+#define KERNEL_DATA_PAGE_SIZE 0x1000
+
+typedef struct {
+    uint64_t sequence;
+
+    // Monotonic clock
+    uint64_t ticks;                 // timer ticks since boot
+    uint64_t nanoseconds;           // at the last tick
+    uint64_t nanosecondsPerTick;
+
+    // TSC calibration, the time since the last tick is (rdtsc - tscAtTick) * nanosecondsPerTick / tscPerTick
+    uint64_t tscAtTick;
+    uint64_t tscPerTick;            // 0 until two ticks have been seen
+
+    // Wall clock, as read from the CMOS RTC once per second (BCD)
+    uint8_t hours;
+    uint8_t minutes;
+    uint8_t seconds;
+
+    // Process running right now, written on every context switch. A single aligned store, outside the sequence
+    volatile int32_t currentPid;
+} KernelData;
+
+#endif // KERNEL_DATA_ABI_H
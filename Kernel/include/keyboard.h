@@ -102,9 +102,12 @@ enum KEYBOARD_OPTIONS {
 };
 
 int8_t getKeyboardCharacter(enum KEYBOARD_OPTIONS keyboard_options);
+uint8_t pollKeyboardCharacter(int8_t * c);
 void addCharToBuffer(int8_t ascii, uint8_t showOutput);
 uint16_t clearBuffer();
 uint8_t keyboardHandler();
+uint8_t isShiftPressed(void);
+uint8_t isExtendedKey(void);
 
 // All special keys *EXCEPT* for TAB and RETURN can be registered
 // Printable keys, including tab (`\t`) and return (`\n`) can be obtained via `getKeyboardCharacter` (`getchar`/`sys_read`)
@@ -8,6 +8,11 @@
 
 void * memset(void * destination, int32_t character, uint64_t length);
 void * memcpy(void * destination, const void * source, uint64_t length);
+
+// Names of kernel objects (shared memory segments, semaphores...), at most `capacity` bytes with the null
+// Copies `name` if it fits, returns 0 otherwise
+uint8_t copyName(char * destination, const char * name, uint64_t capacity);
+uint8_t namesEqual(const char * a, const char * b, uint64_t capacity);
 void printf(const char * string);
 
 uint8_t getKeyboardBuffer(void);
@@ -18,5 +23,13 @@ uint8_t getMinute(void);
 uint8_t getHour(void);
 
 uint8_t * stackInit(void * rsp, void * rip, int argc, char ** argv);
+extern void (*processExitTrampoline)(void); // only its address is used, see `createProcess`
+
+uint64_t readMSR(uint32_t msr);
+void writeMSR(uint32_t msr, uint64_t value);
+uint64_t readTSC(void);
+
+uint8_t inb(uint16_t port);
+void outb(uint16_t port, uint8_t value);
 
 #endif
\ No newline at end of file
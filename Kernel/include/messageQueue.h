@@ -0,0 +1,30 @@
+#ifndef MESSAGE_QUEUE_H
+#define MESSAGE_QUEUE_H
+
+#include <stdint.h>
+#include <message_queue_abi.h>
+
+// Kernel message queues (see `message_queue_abi.h` for the shared limits and statistics)
+// Each queue is a ring of `capacity` slots of `messageSize` bytes. Senders block while it is full, receivers while it is empty
+
+// Opens the queue called `name`, created with the given geometry if there is none yet (an existing one keeps its own)
+// A NULL `name` always creates a new anonymous queue, other processes open it by id with `messageQueueAttach`
+// Return the id, -1 if there is no room or the geometry is out of bounds
+int32_t messageQueueOpen(int pid, const char * name, uint32_t messageSize, uint32_t capacity);
+int32_t messageQueueAttach(int pid, int32_t id);
+
+// Blocking sends return once all `count` messages are queued, blocking receives once at least one was taken
+// With MQ_NON_BLOCKING (or from deferred work) only what fits right now is moved
+// Return the messages moved, -1 if the queue is not open by `pid`
+int32_t messageQueueSend(int pid, int32_t id, const void * messages, uint32_t count, uint32_t flags);
+int32_t messageQueueReceive(int pid, int32_t id, void * messages, uint32_t capacity, uint32_t flags);
+
+int32_t messageQueueStats(int pid, int32_t id, MessageQueueStats * stats);
+
+// The queue is freed once every process that opened it closed it
+int32_t messageQueueClose(int pid, int32_t id);
+
+// Closes everything a process that is going away opened
+void messageQueueRelease(int pid);
+
+#endif // MESSAGE_QUEUE_H
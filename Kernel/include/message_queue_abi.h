@@ -0,0 +1,25 @@
+#ifndef MESSAGE_QUEUE_ABI_H
+#define MESSAGE_QUEUE_ABI_H
+
+#include <stdint.h>
+
+// Shared between the kernel and userland (see `sys_mq_sendv`, `sys_mq_recvv` and `sys_mq_stats`)
+// Queues of fixed size messages. A batch is an array of consecutive messages, moved with a single kernel entry
+
+#define MESSAGE_QUEUE_MAX_MESSAGE_SIZE 256
+#define MESSAGE_QUEUE_MAX_BYTES 16384     // message size times capacity
+
+#define MQ_NON_BLOCKING 0x01 // send or receive what fits right now, 0 if nothing did
+
+typedef struct {
+    uint32_t messageSize;
+    uint32_t capacity;      // messages
+    uint32_t depth;         // messages queued right now
+    uint32_t highWater;     // deepest the queue has been
+    uint64_t sent;          // messages
+    uint64_t received;
+    uint64_t sendCalls;     // batches, `sent / sendCalls` is the messages moved per kernel entry
+    uint64_t receiveCalls;
+} MessageQueueStats;
+
+#endif // MESSAGE_QUEUE_ABI_H
@@ -0,0 +1,32 @@
+#ifndef MUTEX_H
+#define MUTEX_H
+
+#include <stdint.h>
+
+// Sleeping locks with priority inheritance. While a process waits for a mutex, the owner runs at least at the
+// waiter's effective priority, and so does whoever owns the mutex that owner waits for (transitively)
+// Unlocking drops what was inherited through that mutex and hands it to the highest priority waiter
+
+// Opens the mutex called `name`, created unlocked if there is none yet
+// A NULL `name` always creates a new anonymous mutex, other processes open it by id with `mutexAttach`
+// Return the id, -1 if there is no room
+int32_t mutexOpen(int pid, const char * name);
+int32_t mutexAttach(int pid, int32_t id);
+
+// Blocks until `pid` owns the mutex. Returns -1 if it already owns it or waiting would close a cycle (deadlock)
+int32_t mutexLock(int pid, int32_t id);
+
+// Returns -1 if `pid` does not own the mutex
+int32_t mutexUnlock(int pid, int32_t id);
+
+// The mutex is freed once every process that opened it closed it. Closing unlocks it if the caller owns it
+int32_t mutexClose(int pid, int32_t id);
+
+// Recomputes the effective priority of `pid` after its base priority changed, and of the owners it waits behind
+void mutexRefreshPriority(int pid);
+
+// A process or thread that is going away stops waiting and unlocks what it owns
+// A process also closes everything it opened, a thread's opens belong to its process
+void mutexRelease(int pid);
+
+#endif // MUTEX_H
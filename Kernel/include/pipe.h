@@ -0,0 +1,38 @@
+#ifndef PIPE_H
+#define PIPE_H
+
+#include <stdint.h>
+
+// Unidirectional byte channels between processes, each backed by a page sized ring
+// Readers block while the pipe is empty and writers while it is full. Pipes are referenced by id from the fd tables
+
+#define PIPE_BUFFER_SIZE 4096 // one page, power of two
+#define MAX_PIPES 32
+
+typedef enum {
+    PIPE_READ_END = 0,
+    PIPE_WRITE_END,
+} PipeEnd;
+
+// Returns the id of a new pipe with both ends open once, -1 if there is no room
+int pipeCreate(void);
+
+// One more reference to an end (a duplicated or inherited descriptor)
+void pipeOpen(int id, PipeEnd end);
+
+// Drops a reference to an end. The pipe is freed once both ends are closed
+void pipeClose(int id, PipeEnd end);
+
+// Blocks until something was written. Returns the bytes read, 0 once the pipe is empty and every write end is closed
+int64_t pipeRead(int id, char * buffer, uint64_t count);
+
+// Whether `pipeRead` would return right away: something was written or every write end is closed
+uint8_t pipeReadable(int id);
+
+// Blocks until every byte was written. Returns the bytes written, -1 if every read end is closed before anything was
+int64_t pipeWrite(int id, const char * buffer, uint64_t count);
+
+// Called when `pid` terminates: a buffer it lent while blocked in `pipeRead` is not written anymore
+void pipeForgetProcess(int pid);
+
+#endif // PIPE_H
@@ -6,11 +6,13 @@
 #include <stdbool.h>
 
 #include "process_info.h"
+#include "fileDescriptor.h"
+#include "signal_abi.h"
 
 extern int currentPid; // el primer proceso current va a ser el primero en inicializarse
 extern int availableProcesses;
 
-#define MAX_PROCESSES 16
+#define MAX_PROCESSES PROCESS_MAX_COUNT
 #define MIN_PRIORITY PROCESS_PRIORITY_MIN
 #define MAX_PRIORITY PROCESS_PRIORITY_MAX
 #define IDLE_PID PROCESS_IDLE_PID
@@ -19,6 +21,10 @@ extern int availableProcesses;
 #define BACKGROUND false
 // Configuración
 #define PROCESS_STACK_SIZE (16 * 1024) // 16 KiB; ajustá si tu kernel lo necesita
+#define PROCESS_MAX_ARGS 32
+#define PROCESS_ARGS_MAX_SIZE 2048 // name, argument strings and argv, packed at the top of the stack
+#define PROCESS_KILLED_EXIT_CODE -1
+#define THREAD_STACK_SIZE (8 * 1024) // taken from a pool of recycled stacks, see `createThread`
 
 // El orden DEBE COINCIDIR con tu macro pushState en interrupts.asm
 typedef struct
@@ -73,7 +79,8 @@ typedef struct Process
     void *stackBase;  // base del stack --> para la posterior liberacion
     size_t stackSize; // tamaÑo del stack
     uint64_t ctx;  //! Puntero al contexto --> REVISAR
-    int priority;
+    int priority;          // base priority, set with `setProcessPriority`
+    int effectivePriority; // the one the scheduler uses: the base one raised by mutex inheritance
 
     char* name;
     bool isForeground;
@@ -82,6 +89,19 @@ typedef struct Process
 
     void (*entry)(void *); // entry point
     char **Arg;             // argumento inicial
+
+    int parentPid;  // 0 for processes created by the kernel and for orphans
+    int exitCode;   // valid once ZOMBIE
+    int waitingFor; // pid of the child it is blocked on in `waitProcess`, 0 if none
+    void *blockedOn; // WaitQueue it sleeps on, NULL if none
+    int processGroup; // inherited from the parent, Ctrl+C goes to the foreground group (see `signal.h`)
+    int ownerPid;     // the process a thread belongs to and whose descriptors it uses, its own pid for processes
+
+    uint32_t pendingSignals; // bit per signal, see `signal_abi.h`
+    uint32_t blockedSignals;
+    SignalHandler signalHandlers[SIGNAL_COUNT];
+
+    FileDescriptor fds[PROCESS_MAX_FDS];
 } Process;
 
 extern struct Process processTable[MAX_PROCESSES]; // tabla de procesos
@@ -97,8 +117,8 @@ void initProcessSystem(void);
 /**
  * @brief Crea un nuevo proceso y lo deja listo para ser scheduleado.
  *
- * @param Entry      Puntero a la función que el proceso ejecutará.
- * @param Arg        Argumento que se pasará a Entry al arrancar.
+ * @param Entry      Puntero a la función que el proceso ejecutará, recibe (argc, argv).
+ * @param Argv       Argumentos, se copian junto con el nombre al tope del stack del proceso.
  * @param StackBase  Dirección de memoria reservada para el stack del proceso.
  * @param StackSize  Tamaño en bytes del stack apuntado por StackBase.
  * @return Puntero al `Process` creado, o NULL en caso de error (p.ej. sin
@@ -107,17 +127,51 @@ void initProcessSystem(void);
 Process *createProcess(char* name, void (*Entry)(void *), char **Argv, int Argc ,void *StackBase, size_t StackSize, bool isForeground);
 
 /**
- * @brief Termina el proceso actual con el código de salida indicado.
+ * @brief Termina el proceso actual con el código de salida indicado. No retorna.
+ *
+ * El proceso queda ZOMBIE hasta que el padre lo espere; su stack se libera recién
+ * entonces (o, si no tiene padre, después de que el scheduler deja de usarlo).
  *
  * @param ExitCode Código numérico de salida del proceso.
  */
 void exitCurrentProcess(int ExitCode);
 
-//! Agregar comentario
+// The process becomes a ZOMBIE with PROCESS_KILLED_EXIT_CODE. Returns -1 if there is no such (live) process
 int killProcess(int pid);
+int killProcessWithExitCode(int pid, int exitCode);
+
+// `pid` 0 is the caller and `group` 0 a new group led by `pid`. Only the caller and its children can be moved
+int setProcessGroup(int pid, int group);
+
+// A schedulable context inside the current process: it shares its descriptor table (and the flat address space),
+// runs `Entry(arg)` on a small pooled stack and exits with the value it returns. Terminating the process ends its threads
+// Returns NULL if there is no free slot or stack
+Process *createThread(int (*Entry)(void *), void *arg);
+
+// Blocks until `tid`, a thread the caller created, exits. Returns `tid`, -1 if it is not one of them
+int joinThread(int tid, int *exitCode);
+
+// The process whose resources `p` uses: `p` itself unless it is a thread
+Process *getOwnerProcess(Process *p);
+int getOwnerPid(int pid); // `pid` itself if there is no such process
+
+// Whether `pid` is in range to index the process table, the slot may be free
+bool isValidPid(int pid);
+
+// Blocks the current process until its child `pid` exits, then releases the child
+// Returns `pid` and stores the child's exit code in `exitCode` (if not NULL), -1 if `pid` is not a child of the caller
+// With WAIT_NO_HANG in `options` it returns 0 instead of blocking
+int waitProcess(int pid, int *exitCode, int options);
+
+// Called by the scheduler after switching away from `process`: orphan zombies are released from there on
+void releaseIfOrphanZombie(Process *process);
+
 int toggleProcessBlock(int pid);
 int setProcessPriority(int pid, int priority);
 
+// Moves the process to the ready queue of its new effective priority, if it is in one
+void setEffectivePriority(Process *p, int priority);
+
 // ============= HELPERS =============
 
 /**
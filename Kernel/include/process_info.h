@@ -8,12 +8,16 @@ typedef enum {
     READY,
     RUNNING,
     TERMINATED,
-    BLOCKED
+    BLOCKED,
+    ZOMBIE      // exited, keeps its exit code (and stack) until the parent waits for it
 } ProcessState;
 
 #define PROCESS_PRIORITY_MIN 0
 #define PROCESS_PRIORITY_MAX 3
 #define PROCESS_IDLE_PID 1
+#define PROCESS_MAX_COUNT 16 // pids go from 1 to PROCESS_MAX_COUNT
+
+#define WAIT_NO_HANG 0x01 // waitpid option: return 0 right away if the child has not exited yet
 
 typedef struct {
     int pid;
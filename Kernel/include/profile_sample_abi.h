@@ -0,0 +1,20 @@
+#ifndef PROFILE_SAMPLE_ABI_H
+#define PROFILE_SAMPLE_ABI_H
+
+#include <stdint.h>
+
+// Shared between the kernel and userland (see `sys_profiler_control` and `sys_profiler_read`)
+// While the profiler runs, every timer interrupt records where the interrupted process was
+
+#define PROFILER_MAX_SAMPLES 4096 // sampling stops when the buffer is full
+
+typedef struct {
+    uint64_t rip;   // interrupted instruction, in the kernel if the process was inside a system call
+    int32_t pid;
+    uint32_t reserved;
+} ProfileSample;
+
+// Symbol table (see `sys_get_symbol_table`), generated at build time from `kernel.elf` and `shell.elf`:
+// one "<16 hex digit address> <name>\n" line per function, sorted by address, NUL terminated
+
+#endif // PROFILE_SAMPLE_ABI_H
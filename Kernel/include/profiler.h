@@ -0,0 +1,23 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+#include <profile_sample_abi.h>
+
+// `symbolTable` is the module the bootloader loaded it into, empty when the image was packed without one
+void initProfiler(const char * symbolTable);
+
+// Starting discards the samples of the previous run
+void profilerStart(void);
+void profilerStop(void);
+
+// Called by `_irq00Handler` with the interrupted context, before switching processes
+void profilerSample(uint64_t savedContext);
+
+// Copies up to `capacity` samples of the last run, returns how many were copied
+uint32_t profilerRead(ProfileSample * buffer, uint32_t capacity);
+
+// Returns the symbol table length in bytes, 0 if there is none
+uint64_t getSymbolTable(const char ** table);
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+#include <stdint.h>
+#include <process_info.h>
+
+// Bookkeeping shared by the kernel objects processes open by name or by id (semaphores, mutexes, message queues
+// and shared memory segments): which slots are in use, their names and which processes opened each one
+// The module keeps the objects themselves in an array indexed by the same id. An object lives while some process has it open
+// A thread opens, uses and closes objects on behalf of its process: `pid` may be a thread everywhere
+
+#define REGISTRY_MAX_OBJECTS 32 // one bit each in the per process bitmap
+#define REGISTRY_NAME_LENGTH 32 // including the terminating null
+
+typedef struct {
+    uint8_t used[REGISTRY_MAX_OBJECTS];
+    uint32_t references[REGISTRY_MAX_OBJECTS]; // processes that opened it
+    char names[REGISTRY_MAX_OBJECTS][REGISTRY_NAME_LENGTH]; // empty for anonymous objects
+    uint32_t opened[PROCESS_MAX_COUNT]; // indexed by pid - 1, a thread's opens are kept in its process' entry
+} Registry;
+
+// The id of the object called `name`, -1 if there is none (or `name` is NULL)
+int32_t registryFind(const Registry * registry, const char * name);
+
+// Takes a free slot, with no references yet. A NULL `name` makes it anonymous, reachable by id only
+// Returns the id, -1 if every slot is taken or the name does not fit
+int32_t registryCreate(Registry * registry, const char * name);
+
+// Whether `id` is a live object, whoever opened it
+uint8_t registryExists(const Registry * registry, int32_t id);
+
+// Marks `id` as opened by `pid`, taking a reference the first time. Returns 0 if there is no such object
+uint8_t registryAttach(Registry * registry, int pid, int32_t id);
+
+uint8_t registryIsOpen(const Registry * registry, int pid, int32_t id);
+
+// Drops the reference of `pid`, which must have `id` open
+// Returns 1 if it was the last one: the slot is free again and the module frees whatever the object holds
+uint8_t registryClose(Registry * registry, int pid, int32_t id);
+
+// The first object from `id` on that `pid` has open, -1 if none. Used to close everything a process opened
+// A thread has nothing of its own, what it opened goes away with its process
+int32_t registryNextOpened(const Registry * registry, int pid, int32_t id);
+
+#endif // REGISTRY_H
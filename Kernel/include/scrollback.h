@@ -0,0 +1,26 @@
+#ifndef SCROLLBACK_H
+#define SCROLLBACK_H
+
+#include <stdint.h>
+
+// Text history kept as character cells, so it can be paged through after scrolling off the screen
+// Columns are measured in base (font size 1) glyph widths
+
+#define SCROLLBACK_LINES 256
+#define SCROLLBACK_COLUMNS 160
+
+void initScrollback(void);
+
+// Recording, called by the text renderer (`fonts.c`) with the same positions it draws at
+void scrollbackPutGlyph(char ascii, uint64_t x, uint8_t scale, uint32_t foreground, uint32_t background);
+void scrollbackNewLine(uint16_t height, uint16_t nextHeight);
+void scrollbackPreviousLine(void);
+void scrollbackClear(void);
+
+// Paging. Shift+PageUp/PageDown are registered by `initScrollback`
+void scrollbackPageUp(void);
+void scrollbackPageDown(void);
+uint8_t scrollbackIsPaging(void);
+void scrollbackFollow(void);
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef SEMAPHORE_H
+#define SEMAPHORE_H
+
+#include <stdint.h>
+
+// Counting semaphores with their counter in memory userland updates atomically (see `semWait`/`semPost` in libsys)
+// The counter is the available units, negative while processes wait. Userland only enters the kernel when a
+// decrement leaves it negative (to block) or an increment finds it negative (to wake the first waiter)
+
+// Opens the semaphore called `name`, created with `value` units if there is none yet
+// A NULL `name` always creates a new anonymous semaphore, other processes open it by id with `semaphoreAttach`
+// Returns the id and stores the address of the shared counter, -1 if there is no room
+int32_t semaphoreOpen(int pid, const char * name, int32_t value, volatile int32_t ** counter);
+int32_t semaphoreAttach(int pid, int32_t id, volatile int32_t ** counter);
+
+// Slow paths, after the counter was updated in userland
+// Wait blocks until a post hands it a unit (FIFO), post wakes the first waiter or keeps the unit for the next one
+int32_t semaphoreWait(int pid, int32_t id);
+int32_t semaphorePost(int pid, int32_t id);
+
+// The semaphore is freed once every process that opened it closed it
+int32_t semaphoreClose(int pid, int32_t id);
+
+// Gives back a unit a process or thread that is going away was handed but did not take
+// A process also closes everything it opened, a thread's opens belong to its process
+void semaphoreRelease(int pid);
+
+#endif // SEMAPHORE_H
@@ -0,0 +1,23 @@
+#ifndef SHARED_MEMORY_H
+#define SHARED_MEMORY_H
+
+#include <stdint.h>
+
+// Segments carved from the kernel heap that several processes use directly (the address space is shared)
+// A segment lives while some process has it attached, exiting or being killed detaches everything
+
+// Attaches `pid` to the segment called `name`, created zeroed with `size` bytes if there is none yet (`size` 0 only
+// looks it up). A NULL `name` always creates a new anonymous segment, other processes attach to it by id
+// Returns the segment id and stores its address, -1 if it does not exist and can not be created
+int32_t sharedMemoryOpen(int pid, const char * name, uint64_t size, void ** address);
+
+// Returns the segment size and stores its address, -1 if there is no such segment
+int32_t sharedMemoryAttach(int pid, int32_t id, void ** address);
+
+// The segment is freed when its last process detaches. Returns -1 if `pid` was not attached to it
+int32_t sharedMemoryDetach(int pid, int32_t id);
+
+// Detaches a process that is going away from every segment
+void sharedMemoryRelease(int pid);
+
+#endif // SHARED_MEMORY_H
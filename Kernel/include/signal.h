@@ -0,0 +1,38 @@
+#ifndef SIGNAL_H
+#define SIGNAL_H
+
+#include <stdint.h>
+#include <signal_abi.h>
+#include <process.h>
+
+// Signals are recorded in the target's pending mask. Default actions are taken right away, handlers run the
+// next time the scheduler resumes the process in its own code (not inside a system call), with the signal blocked
+
+// What `signalDeliver` leaves on the process' stack, below the interrupted state. `signalTrampoline` depends on the layout
+typedef struct {
+    uint64_t blockedSignals; // restored when the handler returns
+    uint64_t reserved;       // keeps `interrupted` 16 byte aligned
+    StackFrame interrupted;
+} SignalFrame;
+
+// `pid` negative sends to every process in group -pid. Returns -1 if there is no such process
+int32_t signalSend(int pid, int signal);
+
+// Ctrl+C: SIGINT to the foreground process group, if any
+void signalInterruptForeground(void);
+void signalSetForegroundGroup(int group);
+
+// Stores the previous handler (if `previous` is not NULL). SIGKILL keeps its default action
+int32_t signalSetHandler(int pid, int signal, SignalHandler handler, SignalHandler * previous);
+
+// Replaces the blocked mask, blocked signals stay pending. SIGKILL can not be blocked
+int32_t signalSetMask(int pid, uint32_t mask, uint32_t * previous);
+
+// Called by `schedule` with the process about to run. Returns its context, redirected into the trampoline
+// if a handler has to run first
+uint64_t signalDeliver(Process * process);
+
+// Called by `signalTrampoline` once the handler returned, with interrupts disabled
+void signalReturn(SignalFrame * frame);
+
+#endif // SIGNAL_H
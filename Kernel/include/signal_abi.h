@@ -0,0 +1,25 @@
+#ifndef SIGNAL_ABI_H
+#define SIGNAL_ABI_H
+
+#include <stdint.h>
+
+// Shared between the kernel and userland (see `sys_signal_send` and `sys_signal_handler`)
+// Every signal's default action terminates the process with exit code SIGNAL_EXIT_CODE(signal)
+
+#define SIGNAL_COUNT 32 // one bit each in the pending and blocked masks, 0 is not a signal
+
+#define SIGINT 2    // Ctrl+C, sent to the foreground process group
+#define SIGKILL 9   // can not be handled, ignored or blocked
+#define SIGUSR1 10
+#define SIGUSR2 12
+#define SIGTERM 15
+
+#define SIGNAL_MASK(signal) (1u << (signal))
+#define SIGNAL_EXIT_CODE(signal) (128 + (signal))
+
+typedef void (*SignalHandler)(int signal);
+
+#define SIG_DFL ((SignalHandler) 0)
+#define SIG_IGN ((SignalHandler) 1)
+
+#endif // SIGNAL_ABI_H
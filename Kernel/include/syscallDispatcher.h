@@ -4,6 +4,15 @@
 #include <stdint.h>
 #include <keyboard.h>
 #include <process_info.h>
+#include <draw_command_abi.h>
+#include <syscall_stats_abi.h>
+#include <kernel_data_abi.h>
+#include <io_ring_abi.h>
+#include <irq_stats_abi.h>
+#include <message_queue_abi.h>
+#include <signal_abi.h>
+#include <profile_sample_abi.h>
+#include <trace_event_abi.h>
 #include <string.h>
 
 typedef struct {
@@ -28,8 +37,19 @@ typedef struct {
 int32_t syscallDispatcher(Registers * registers);
 
 // Linux syscall prototypes
-int32_t sys_write(int32_t fd, char * __user_buf, int32_t count);
-int32_t sys_read(int32_t fd, signed char * __user_buf, int32_t count);
+int32_t sys_exit(int32_t exitCode);
+int32_t sys_write(int32_t fd, const void * buffer, int32_t count);
+int32_t sys_read(int32_t fd, void * buffer, int32_t count);
+// Blocks until the child `pid` exits, stores its exit code. Returns `pid`, -1 if it is not a child of the caller
+// With WAIT_NO_HANG in `options` it returns 0 if the child is still running
+int32_t sys_waitpid(int32_t pid, int32_t * exitCode, int32_t options);
+int32_t sys_close(int32_t fd);
+// Returns the lowest free descriptor, now referring to the same file as `fd`
+int32_t sys_dup(int32_t fd);
+// Closes `newFd` if it was open and makes it refer to the same file as `fd`. Returns `newFd`
+int32_t sys_dup2(int32_t fd, int32_t newFd);
+// Stores the read end in fds[0] and the write end in fds[1]
+int32_t sys_pipe(int32_t * fds);
 
 // Custom syscall prototypes
 int32_t sys_start_beep(uint32_t nFrequence);
@@ -41,19 +61,69 @@ int32_t sys_fonts_increase_size(void);
 int32_t sys_fonts_set_size(uint8_t size);
 int32_t sys_clear_screen(void);
 int32_t sys_clear_input_buffer(void);
-uint16_t sys_window_width(void);
-uint16_t sys_window_height(void);
+int32_t sys_window_width(void);
+int32_t sys_window_height(void);
 
 // Date syscall prototypes
 int32_t sys_hour(int * hour);
 int32_t sys_minute(int * minute);
 int32_t sys_second(int * second);
+// Stores the address of the kernel data page (see `kernel_data_abi.h`) in `*data`
+int32_t sys_get_kernel_data(const KernelData ** data);
 
 
 int32_t sys_circle(uint32_t hexColor, uint64_t topLeftX, uint64_t topLeftY, uint64_t diameter);
+// Filled or outlined (DRAW_OUTLINE) ellipse inside the given bounding box
+int32_t sys_ellipse(uint32_t hexColor, int64_t topLeftX, int64_t topLeftY, uint64_t width, uint64_t height, uint32_t flags);
 // Draw rectangle syscall prototype
-int32_t sys_rectangle(uint32_t color, uint64_t width_pixels, uint64_t height_pixels, uint64_t initial_pos_x, uint64_t initial_pos_y);
+int32_t sys_rectangle(uint32_t color, uint64_t width_pixels, uint64_t height_pixels, int64_t initial_pos_x, int64_t initial_pos_y);
 int32_t sys_fill_video_memory(uint32_t hexColor);
+// Executes `count` draw commands in a single kernel entry, returns the amount executed
+int32_t sys_draw_batch(const DrawCommand * commands, uint64_t count);
+int32_t sys_blit(const BlitRequest * request, int64_t x, int64_t y);
+
+// Submission/completion rings (see `io_ring_abi.h`)
+int32_t sys_io_ring_setup(IoRing * ring);
+// Consumes up to `toSubmit` queued operations and waits for `minComplete` completions, returns the operations consumed
+int32_t sys_io_ring_enter(uint32_t toSubmit, uint32_t minComplete);
+
+// Shared memory segments (see `sharedMemory.h`)
+int32_t sys_shm_open(const char * name, uint64_t size, void ** address);
+int32_t sys_shm_attach(int32_t id, void ** address);
+int32_t sys_shm_detach(int32_t id);
+
+// Semaphore slow paths, the counter is updated in userland (see `semaphore.h`)
+int32_t sys_sem_open(const char * name, int32_t value, volatile int32_t ** counter);
+int32_t sys_sem_attach(int32_t id, volatile int32_t ** counter);
+int32_t sys_sem_wait(int32_t id);
+int32_t sys_sem_post(int32_t id);
+int32_t sys_sem_close(int32_t id);
+
+// Sleeping locks with priority inheritance (see `mutex.h`)
+int32_t sys_mutex_open(const char * name);
+int32_t sys_mutex_attach(int32_t id);
+int32_t sys_mutex_lock(int32_t id);
+int32_t sys_mutex_unlock(int32_t id);
+int32_t sys_mutex_close(int32_t id);
+
+// Fixed size message queues, moving a batch of messages per call (see `message_queue_abi.h`)
+int32_t sys_mq_open(const char * name, uint32_t messageSize, uint32_t capacity);
+int32_t sys_mq_attach(int32_t id);
+int32_t sys_mq_sendv(int32_t id, const void * messages, uint32_t count, uint32_t flags);
+int32_t sys_mq_recvv(int32_t id, void * messages, uint32_t capacity, uint32_t flags);
+int32_t sys_mq_stats(int32_t id, MessageQueueStats * stats);
+int32_t sys_mq_close(int32_t id);
+
+// Signals (see `signal.h`), a negative pid addresses a process group
+int32_t sys_signal_send(int32_t pid, int32_t signal);
+int32_t sys_signal_handler(int32_t signal, SignalHandler handler, SignalHandler * previous);
+int32_t sys_signal_mask(uint32_t mask, uint32_t * previous);
+int32_t sys_set_process_group(int32_t pid, int32_t group);
+int32_t sys_set_foreground_group(int32_t group);
+
+// Threads of the calling process (see `createThread`)
+int32_t sys_thread_create(int32_t (*entry)(void *), void * arg);
+int32_t sys_thread_join(int32_t tid, int32_t * exitCode);
 
 // Custom exec syscall prototype
 int32_t sys_exec(int32_t (*fnPtr)(void));
@@ -67,6 +137,21 @@ int32_t sys_sleep_milis(uint32_t milis);
 
 // Register snapshot
 int32_t sys_get_register_snapshot(int64_t * registers);
+int32_t sys_nop(void);
+// Fills up to `capacity` entries, one per system call, returns how many were written
+int32_t sys_get_syscall_stats(SyscallStats * userBuffer, uint64_t capacity);
+// Fills up to `capacity` entries, one per interrupt source (see `irq_stats_abi.h`), returns how many were written
+int32_t sys_get_irq_stats(IrqStats * userBuffer, uint64_t capacity);
+// Starts (discarding the previous samples) or stops the sampling profiler
+int32_t sys_profiler_control(uint64_t enable);
+// Copies up to `capacity` samples of the last run, returns how many were copied
+int32_t sys_profiler_read(ProfileSample * userBuffer, uint64_t capacity);
+// Stores the address of the symbol table (see `profile_sample_abi.h`) in `table`, returns its length in bytes
+int32_t sys_get_symbol_table(const char ** table);
+// Enables or disables the kernel tracepoints, returns whether they were enabled
+int32_t sys_trace_control(uint64_t enable);
+// Copies up to `capacity` trace events from event number `*cursor` on and advances it, returns how many were copied
+int32_t sys_trace_read(TraceEvent * userBuffer, uint64_t capacity, uint64_t * cursor);
 
 // Get character without showing
 int32_t sys_get_character_without_display(void);
@@ -76,5 +161,9 @@ int32_t sys_kill_process(int32_t pid);
 int32_t sys_toggle_block_process(int32_t pid);
 int32_t sys_get_memory_state(char *userBuffer, uint64_t capacity);
 int32_t sys_set_process_priority(int32_t pid, int32_t priority);
+// Starts `entry(argc, argv)` in a new process named after argv[0], the arguments are copied into its stack. Returns its pid or -1
+int32_t sys_create_process(void * entry, char ** argv, uint64_t argc, int32_t priority, uint64_t foreground);
+// Gives up the rest of the time slice
+int32_t sys_yield(void);
 
 #endif
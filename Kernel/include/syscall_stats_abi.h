@@ -0,0 +1,21 @@
+#ifndef SYSCALL_STATS_ABI_H
+#define SYSCALL_STATS_ABI_H
+
+#include <stdint.h>
+
+// Shared between the kernel and userland (see `sys_get_syscall_stats`)
+
+#define SYSCALL_NAME_LENGTH 40
+#define SYSCALL_HISTOGRAM_BUCKETS 32
+
+typedef struct {
+    uint64_t id;
+    char name[SYSCALL_NAME_LENGTH];
+    uint64_t calls;
+    uint64_t totalCycles;
+    // `histogram[i]`: calls that took [2^i, 2^(i+1)) TSC cycles, the last bucket also holds anything slower
+    // Blocking system calls (read, sleep...) include the time spent waiting
+    uint64_t histogram[SYSCALL_HISTOGRAM_BUCKETS];
+} SyscallStats;
+
+#endif
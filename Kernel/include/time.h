@@ -2,13 +2,17 @@
 #define _TIME_H_
 
 #include <stdint.h>
+#include <kernel_data_abi.h>
 
 #define SECONDS_TO_TICKS 18
+#define TICK_NANOSECONDS 54925439ULL // PIT channel 0 at its default divisor (1193182 Hz / 65536), the LAPIC timer keeps it
 
 void timer_handler();
 int ticks_elapsed();
 int seconds_elapsed();
 void sleep(int seconds);
 void sleepTicks(uint64_t sleep_t);
+const KernelData * getKernelData(void);
+void setKernelDataPid(int pid);
 
 #endif
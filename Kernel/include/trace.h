@@ -0,0 +1,28 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <trace_event_abi.h>
+
+// Static tracepoints: `TRACE(type, arg0, arg1)` records a `TraceEvent` while tracing is enabled
+// Off until `trace on` (`traceSetEnabled`). Building with `make TRACE=0` removes them altogether
+
+extern volatile uint8_t traceEnabled;
+
+#if KERNEL_TRACE
+#define TRACE(type, arg0, arg1) do { if (traceEnabled) traceRecord((type), (uint64_t)(arg0), (uint64_t)(arg1)); } while (0)
+#else
+#define TRACE(type, arg0, arg1) ((void)0)
+#endif
+
+// Safe from any context, including nested interrupts: each writer reserves its own slot
+void traceRecord(uint16_t type, uint64_t arg0, uint64_t arg1);
+
+// Returns the previous state
+uint8_t traceSetEnabled(uint8_t enabled);
+
+// Copies up to `capacity` events from event number `*cursor` on and advances it past the last one copied
+// Events already overwritten are skipped. Returns how many were copied
+uint32_t traceRead(TraceEvent * buffer, uint32_t capacity, uint64_t * cursor);
+
+#endif
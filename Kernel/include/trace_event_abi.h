@@ -0,0 +1,33 @@
+#ifndef TRACE_EVENT_ABI_H
+#define TRACE_EVENT_ABI_H
+
+#include <stdint.h>
+
+// Shared between the kernel and userland (see `sys_trace_control` and `sys_trace_read`)
+// Kernel events recorded by the static tracepoints, in order, into a ring that overwrites the oldest ones
+
+#define TRACE_BUFFER_ENTRIES 4096 // power of two
+
+typedef enum {
+    TRACE_SWITCH = 1,       // arg0: pid switched to (`pid` is the one switched away from)
+    TRACE_PROCESS_CREATE,   // arg0: new pid, arg1: entry point
+    TRACE_PROCESS_EXIT,     // arg0: pid, arg1: exit code
+    TRACE_PROCESS_KILL,     // arg0: pid, arg1: exit code
+    TRACE_BLOCK,            // arg0: pid, arg1: child waited for or wait queue, 0 if blocked by hand
+    TRACE_UNBLOCK,          // arg0: pid
+    TRACE_ALLOC,            // arg0: bytes requested, arg1: address
+    TRACE_FREE,             // arg1: address
+    TRACE_SYSCALL_ENTER,    // arg0: system call ID, arg1: first argument
+    TRACE_SYSCALL_EXIT,     // arg0: system call ID, arg1: result
+} TraceEventType;
+
+typedef struct {
+    uint64_t tsc;
+    uint32_t sequence;      // low bits of the event number + 1, 0 while the event is being written
+    uint16_t type;          // TraceEventType
+    int16_t pid;            // running process, 0 if none
+    uint64_t arg0;
+    uint64_t arg1;
+} TraceEvent;
+
+#endif // TRACE_EVENT_ABI_H
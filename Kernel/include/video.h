@@ -2,11 +2,17 @@
 #define VIDEO_DRIVER_H
 
 #include <stdint.h>
+#include <blit_request_abi.h>
 
 void putPixel(uint32_t hexColor, uint64_t x, uint64_t y);
+void drawEllipse(uint32_t hexColor, int64_t topLeftX, int64_t topLeftY, uint64_t width, uint64_t height, uint8_t outline);
 void drawCircle(uint32_t hexColor, uint64_t topLeftX, uint64_t topLeftY, uint64_t diameter);
-void drawRectangle(uint32_t hexColor, uint64_t width, uint64_t height, uint64_t initial_pos_x, uint64_t initial_pos_y);
+void drawRectangle(uint32_t hexColor, uint64_t width, uint64_t height, int64_t initial_pos_x, int64_t initial_pos_y);
+void drawLine(uint32_t hexColor, int64_t x0, int64_t y0, int64_t x1, int64_t y1);
+void drawBitmap(const uint32_t * pixels, uint64_t width, uint64_t height, int64_t x, int64_t y);
+int8_t blitBitmap(const BlitRequest * request, int64_t x, int64_t y);
 void fillVideoMemory(uint32_t hexColor);
+void drawGlyphRun(const char * glyphs, uint64_t count, const uint8_t * font, uint16_t glyphHeight, uint64_t x, uint64_t y, uint8_t scale, uint32_t hexColor, uint32_t backgroundColor);
 
 uint16_t getWindowWidth(void);
 uint16_t getWindowHeight(void);
@@ -0,0 +1,34 @@
+#ifndef WAIT_QUEUE_H
+#define WAIT_QUEUE_H
+
+#include <stdint.h>
+#include "process_info.h"
+
+// Processes blocked on a kernel object (pipe end, semaphore...), woken in FIFO order
+// A process sleeps on at most one queue at a time, so PROCESS_MAX_COUNT entries always fit
+typedef struct {
+    int pids[PROCESS_MAX_COUNT];
+    uint8_t head;
+    uint8_t count;
+} WaitQueue;
+
+void waitQueueInit(WaitQueue * queue);
+
+// Interrupts must be disabled (system call context), they are disabled again on return
+// Wakeups can be spurious (`toggleProcessBlock`, other IRQs): callers sleep in a loop that rechecks their condition
+// Must not be called from deferred work, it runs on the interrupted process' stack
+void waitQueueSleep(WaitQueue * queue);
+
+// Returns the pid made READY, 0 if nobody was waiting
+int waitQueueWakeOne(WaitQueue * queue);
+
+// Returns how many processes were made READY
+uint8_t waitQueueWakeAll(WaitQueue * queue);
+
+// Wakes `pid` out of FIFO order (e.g. the highest priority waiter). Returns 0 if it was not asleep on the queue
+uint8_t waitQueueWake(WaitQueue * queue, int pid);
+
+// Takes `pid` off the queue without waking it (the process is being terminated)
+void waitQueueRemove(WaitQueue * queue, int pid);
+
+#endif // WAIT_QUEUE_H
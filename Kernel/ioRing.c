@@ -0,0 +1,219 @@
+#include <ioRing.h>
+#include <stddef.h>
+#include <time.h>
+#include <process.h>
+#include <syscallDispatcher.h>
+#include <fileDescriptor.h>
+#include <waitQueue.h>
+#include <deferredWork.h>
+
+#define BARRIER() __asm__ volatile ("" ::: "memory")
+
+typedef struct {
+    IoRing * ring;
+    uint32_t inFlight; // consumed submissions without a completion yet, reserves completion slots
+    WaitQueue completed; // `ioRingEnter` waiting for completions
+} RingSlot;
+
+typedef struct {
+    int pid;                // 0 when the slot is free
+    uint32_t opcode;
+    uint64_t userData;
+    uint64_t deadline;      // IO_OP_SLEEP: tick it completes at
+    int32_t fd;             // IO_OP_READ
+    char * buffer;
+    uint64_t length;
+} PendingOperation;
+
+static RingSlot rings[MAX_PROCESSES]; // indexed by pid - 1
+static PendingOperation pending[IO_RING_MAX_PENDING];
+
+static RingSlot * ringOf(int pid) {
+    if (pid <= 0 || pid > MAX_PROCESSES || rings[pid - 1].ring == NULL) {
+        return NULL;
+    }
+    return &rings[pid - 1];
+}
+
+static uint32_t completionsReady(const IoRing * ring) {
+    return ring->completionTail - ring->completionHead;
+}
+
+static void postCompletion(RingSlot * slot, uint64_t userData, int64_t result) {
+    IoRing * ring = slot->ring;
+    IoCompletion * completion = &ring->completions[ring->completionTail % IO_RING_COMPLETION_ENTRIES];
+    completion->userData = userData;
+    completion->result = result;
+
+    BARRIER(); // the entry must be visible before the new tail
+    ring->completionTail++;
+    slot->inFlight--;
+    waitQueueWakeAll(&slot->completed);
+}
+
+static PendingOperation * freePendingSlot(void) {
+    for (int i = 0; i < IO_RING_MAX_PENDING; i++) {
+        if (pending[i].pid == 0) {
+            return &pending[i];
+        }
+    }
+    return NULL;
+}
+
+// Returns 1 if the operation completed right away, 0 if it stays pending
+static uint8_t execute(RingSlot * slot, int pid, const IoSubmission * submission) {
+    int64_t result;
+
+    switch (submission->opcode) {
+        case IO_OP_NOP:
+            result = 0;
+            break;
+        case IO_OP_WRITE:
+            // Drained on the tick, the running process is whichever one was interrupted: use the ring owner's descriptors
+            result = submission->address == 0 ? -1 : fdWriteFor(pid, submission->fd, (const char *) submission->address, submission->length);
+            break;
+        case IO_OP_DRAW:
+            result = sys_draw_batch((const DrawCommand *) submission->address, submission->length);
+            break;
+        case IO_OP_KILL:
+            // Killing the owner from `ioRingEnter` does not return to its code, same as `sys_kill_process`
+            result = sys_kill_process(submission->fd);
+            break;
+        case IO_OP_SET_PRIORITY:
+            result = setProcessPriority(submission->fd, (int) submission->length);
+            break;
+        case IO_OP_TOGGLE_BLOCK:
+            result = toggleProcessBlock(submission->fd);
+            break;
+        case IO_OP_READ:
+            // Through the ring owner's descriptors, like writes
+            result = fdReadFor(pid, submission->fd, (char *) submission->address, submission->length);
+            if (result != FD_WOULD_BLOCK) {
+                break;
+            }
+            // fallthrough, nothing to read yet
+        case IO_OP_SLEEP: {
+            PendingOperation * operation = freePendingSlot(); // reserved by the caller, never NULL here
+            operation->pid = pid;
+            operation->opcode = submission->opcode;
+            operation->userData = submission->userData;
+            operation->deadline = ticks_elapsed() + (submission->length * SECONDS_TO_TICKS + 999) / 1000;
+            operation->fd = submission->fd;
+            operation->buffer = (char *) submission->address;
+            operation->length = submission->length;
+            return 0;
+        }
+        default:
+            result = -1;
+            break;
+    }
+
+    postCompletion(slot, submission->userData, result);
+    return 1;
+}
+
+// Stops early when the completion ring could overflow or there is no room to park an operation
+static uint32_t consumeSubmissions(RingSlot * slot, int pid, uint32_t toSubmit) {
+    IoRing * ring = slot->ring;
+    uint32_t consumed = 0;
+
+    while (consumed < toSubmit && ring->submissionHead != ring->submissionTail) {
+        if (completionsReady(ring) + slot->inFlight >= IO_RING_COMPLETION_ENTRIES || freePendingSlot() == NULL) {
+            break;
+        }
+
+        BARRIER(); // read the entry only after seeing the tail that published it
+        IoSubmission submission = ring->submissions[ring->submissionHead % IO_RING_ENTRIES];
+        ring->submissionHead++;
+        slot->inFlight++;
+        consumed++;
+
+        execute(slot, pid, &submission);
+
+        // The submission may have killed its own process
+        if (ringOf(pid) != slot) {
+            break;
+        }
+    }
+
+    return consumed;
+}
+
+int32_t ioRingSetup(int pid, IoRing * ring) {
+    if (ring == NULL || pid <= 0 || pid > MAX_PROCESSES) {
+        return -1;
+    }
+
+    ioRingRelease(pid);
+
+    ring->submissionHead = ring->submissionTail = 0;
+    ring->completionHead = ring->completionTail = 0;
+    rings[pid - 1].ring = ring;
+    rings[pid - 1].inFlight = 0;
+    waitQueueInit(&rings[pid - 1].completed);
+    return 0;
+}
+
+int32_t ioRingEnter(int pid, uint32_t toSubmit, uint32_t minComplete) {
+    RingSlot * slot = ringOf(pid);
+    if (slot == NULL) {
+        return -1;
+    }
+
+    uint32_t consumed = consumeSubmissions(slot, pid, toSubmit);
+
+    // Pending operations are completed by the timer tick, which wakes the queue
+    while (ringOf(pid) == slot && completionsReady(slot->ring) < minComplete && slot->inFlight > 0 && !deferredWorkIsRunning()) {
+        waitQueueSleep(&slot->completed);
+    }
+
+    return (int32_t) consumed;
+}
+
+void ioRingOnTick(void) {
+    uint64_t now = ticks_elapsed();
+
+    for (int i = 0; i < IO_RING_MAX_PENDING; i++) {
+        PendingOperation * operation = &pending[i];
+        if (operation->pid == 0) {
+            continue;
+        }
+
+        int64_t result;
+        if (operation->opcode == IO_OP_SLEEP) {
+            if (now < operation->deadline) continue;
+            result = 0;
+        } else {
+            result = fdReadFor(operation->pid, operation->fd, operation->buffer, operation->length);
+            if (result == FD_WOULD_BLOCK) continue;
+        }
+
+        RingSlot * slot = ringOf(operation->pid);
+        operation->pid = 0;
+        if (slot != NULL) {
+            postCompletion(slot, operation->userData, result);
+        }
+    }
+
+    for (int pid = 1; pid <= MAX_PROCESSES; pid++) {
+        RingSlot * slot = ringOf(pid);
+        if (slot != NULL && (slot->ring->flags & IO_RING_DRAIN_ON_TICK)) {
+            consumeSubmissions(slot, pid, IO_RING_ENTRIES);
+        }
+    }
+}
+
+void ioRingRelease(int pid) {
+    if (pid <= 0 || pid > MAX_PROCESSES) {
+        return;
+    }
+
+    for (int i = 0; i < IO_RING_MAX_PENDING; i++) {
+        if (pending[i].pid == pid) {
+            pending[i].pid = 0;
+        }
+    }
+
+    rings[pid - 1].ring = NULL;
+    rings[pid - 1].inFlight = 0;
+}
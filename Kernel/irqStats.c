@@ -0,0 +1,73 @@
+#include <irqStats.h>
+#include <lib.h>
+
+static const char * const sourceNames[IRQ_SOURCE_COUNT] = {
+    [IRQ_SOURCE_TIMER] = "timer",
+    [IRQ_SOURCE_KEYBOARD] = "keyboard",
+    [IRQ_SOURCE_INT80] = "int 80h",
+    [IRQ_SOURCE_SYSCALL] = "syscall",
+    [IRQ_SOURCE_DEFERRED] = "deferred work",
+    [IRQ_SOURCE_MASKED] = "cli..sti",
+};
+
+static struct {
+    uint64_t count;
+    uint64_t totalCycles;
+    uint64_t maxCycles;
+    uint64_t histogram[IRQ_HISTOGRAM_BUCKETS];
+} stats[IRQ_SOURCE_COUNT];
+
+// Only for the IRQ handlers, which never nest: they run with interrupts disabled up to `irqExit`
+// System calls can block mid-call and let another one in, they keep their own stamp (see `irqExitSince`)
+static uint64_t entryStamps[IRQ_SOURCE_COUNT];
+
+void recordIrqCycles(uint32_t source, uint64_t cycles) {
+    if (source >= IRQ_SOURCE_COUNT) {
+        return;
+    }
+
+    uint8_t bucket = cycles == 0 ? 0 : 63 - __builtin_clzll(cycles);
+    if (bucket >= IRQ_HISTOGRAM_BUCKETS) bucket = IRQ_HISTOGRAM_BUCKETS - 1;
+
+    stats[source].count++;
+    stats[source].totalCycles += cycles;
+    if (cycles > stats[source].maxCycles) stats[source].maxCycles = cycles;
+    stats[source].histogram[bucket]++;
+}
+
+void irqEnter(uint32_t source) {
+    if (source < IRQ_SOURCE_COUNT) {
+        entryStamps[source] = readTSC();
+    }
+}
+
+void irqExit(uint32_t source) {
+    if (source < IRQ_SOURCE_COUNT) {
+        recordIrqCycles(source, readTSC() - entryStamps[source]);
+    }
+}
+
+void irqExitSince(uint32_t source, uint64_t since) {
+    recordIrqCycles(source, readTSC() - since);
+}
+
+void recordMaskedSection(uint64_t since) {
+    recordIrqCycles(IRQ_SOURCE_MASKED, readTSC() - since);
+}
+
+uint32_t getIrqStats(IrqStats * buffer, uint32_t capacity) {
+    uint32_t count = capacity < IRQ_SOURCE_COUNT ? capacity : IRQ_SOURCE_COUNT;
+    for (uint32_t i = 0; i < count; i++) {
+        IrqStats * entry = &buffer[i];
+        uint32_t len = 0;
+        for (; sourceNames[i][len] != 0 && len + 1 < IRQ_STATS_NAME_LENGTH; len++) {
+            entry->name[len] = sourceNames[i][len];
+        }
+        entry->name[len] = 0;
+        entry->count = stats[i].count;
+        entry->totalCycles = stats[i].totalCycles;
+        entry->maxCycles = stats[i].maxCycles;
+        memcpy(entry->histogram, stats[i].histogram, sizeof(entry->histogram));
+    }
+    return count;
+}
@@ -7,6 +7,8 @@
 #include <fonts.h>
 #include <syscallDispatcher.h>
 #include <sound.h>
+#include <scrollback.h>
+#include <profiler.h>
 #include "process.h"
 #include "scheduler.h"
 #include "MemoryManager.h"
@@ -21,7 +23,7 @@ extern uint8_t endOfKernel;
 static const uint64_t PageSize = 0x1000;
 
 static void * const shellModuleAddress = (void *)0x400000;
-static void * const snakeModuleAddress = (void *)0x500000;
+static void * const symbolsModuleAddress = (void *)0x500000;
 
 typedef int (*EntryPoint)();
 
@@ -41,7 +43,7 @@ void * getStackBase() {
 void * initializeKernelBinary(){
 	void * moduleAddresses[] = {
 		shellModuleAddress,
-		snakeModuleAddress,
+		symbolsModuleAddress,
 	};
 
 	loadModules(&endOfKernelBinary, moduleAddresses);
@@ -61,6 +63,10 @@ void idleProcessMain(void* arg) { // el parámetro no se usa pero es por convenc
 int main(){	
 	load_idt();
 
+	initScrollback();
+
+	initProfiler((const char *)symbolsModuleAddress);
+
     createMemory((void *)0xF00000, (1<<20));
 
 	initProcessSystem(); // este init llama al initScheduler
@@ -49,3 +49,27 @@ void * memcpy(void * destination, const void * source, uint64_t length)
 
 	return destination;
 }
+
+uint8_t copyName(char * destination, const char * name, uint64_t capacity)
+{
+	for (uint64_t i = 0; i < capacity; i++)
+	{
+		destination[i] = name[i];
+		if (name[i] == 0)
+			return 1;
+	}
+
+	if (capacity > 0)
+		destination[0] = 0;
+	return 0;
+}
+
+uint8_t namesEqual(const char * a, const char * b, uint64_t capacity)
+{
+	for (uint64_t i = 0; i < capacity && a[i] == b[i]; i++)
+	{
+		if (a[i] == 0)
+			return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,185 @@
+#include <messageQueue.h>
+#include <stddef.h>
+#include <lib.h>
+#include <MemoryManager.h>
+#include <process.h>
+#include <waitQueue.h>
+#include <deferredWork.h>
+#include <registry.h>
+
+typedef struct {
+    char * slots;
+    uint64_t head;          // free running, the slot is `index % capacity`
+    uint64_t tail;
+    MessageQueueStats stats;
+    WaitQueue sendQueue;
+    WaitQueue receiveQueue;
+} MessageQueue;
+
+static Registry registry;
+static MessageQueue queues[REGISTRY_MAX_OBJECTS];
+
+// NULL unless `pid` opened queue `id`
+static MessageQueue * queueOf(int pid, int32_t id) {
+    return registryIsOpen(&registry, pid, id) ? &queues[id] : NULL;
+}
+
+static uint32_t min(uint32_t a, uint32_t b) {
+    return a < b ? a : b;
+}
+
+static int32_t create(const char * name, uint32_t messageSize, uint32_t capacity) {
+    if (messageSize == 0 || messageSize > MESSAGE_QUEUE_MAX_MESSAGE_SIZE || capacity == 0
+        || capacity > MESSAGE_QUEUE_MAX_BYTES / messageSize) {
+        return -1;
+    }
+
+    char * slots = allocMemory((uint64_t) messageSize * capacity);
+    if (slots == NULL) {
+        return -1;
+    }
+
+    int32_t id = registryCreate(&registry, name);
+    if (id < 0) {
+        freeMemory(slots);
+        return -1;
+    }
+
+    MessageQueue * queue = &queues[id];
+    queue->slots = slots;
+    queue->head = queue->tail = 0;
+    memset(&queue->stats, 0, sizeof(queue->stats));
+    queue->stats.messageSize = messageSize;
+    queue->stats.capacity = capacity;
+    waitQueueInit(&queue->sendQueue);
+    waitQueueInit(&queue->receiveQueue);
+    return id;
+}
+
+int32_t messageQueueOpen(int pid, const char * name, uint32_t messageSize, uint32_t capacity) {
+    if (!isValidPid(pid) || (name != NULL && name[0] == 0)) {
+        return -1;
+    }
+
+    int32_t id = registryFind(&registry, name);
+    if (id < 0) {
+        id = create(name, messageSize, capacity);
+    }
+
+    if (id < 0) {
+        return -1;
+    }
+    return messageQueueAttach(pid, id);
+}
+
+int32_t messageQueueAttach(int pid, int32_t id) {
+    return registryAttach(&registry, pid, id) ? id : -1;
+}
+
+// Copies `count` messages between a batch and the ring, at most two chunks: up to the end of the ring and from its start
+static void copyIn(MessageQueue * queue, const char * messages, uint32_t count) {
+    uint32_t size = queue->stats.messageSize;
+    uint32_t offset = queue->tail % queue->stats.capacity;
+    uint32_t first = min(count, queue->stats.capacity - offset);
+    memcpy(queue->slots + (uint64_t) offset * size, messages, (uint64_t) first * size);
+    memcpy(queue->slots, messages + (uint64_t) first * size, (uint64_t) (count - first) * size);
+    queue->tail += count;
+}
+
+static void copyOut(MessageQueue * queue, char * messages, uint32_t count) {
+    uint32_t size = queue->stats.messageSize;
+    uint32_t offset = queue->head % queue->stats.capacity;
+    uint32_t first = min(count, queue->stats.capacity - offset);
+    memcpy(messages, queue->slots + (uint64_t) offset * size, (uint64_t) first * size);
+    memcpy(messages + (uint64_t) first * size, queue->slots, (uint64_t) (count - first) * size);
+    queue->head += count;
+}
+
+int32_t messageQueueSend(int pid, int32_t id, const void * messages, uint32_t count, uint32_t flags) {
+    MessageQueue * queue = queueOf(pid, id);
+    if (queue == NULL || (messages == NULL && count > 0)) {
+        return -1;
+    }
+
+    queue->stats.sendCalls++;
+    uint32_t sent = 0;
+    while (sent < count) {
+        uint32_t space = queue->stats.capacity - queue->stats.depth;
+        if (space == 0) {
+            if ((flags & MQ_NON_BLOCKING) || deferredWorkIsRunning()) {
+                break;
+            }
+            waitQueueSleep(&queue->sendQueue);
+            continue;
+        }
+
+        uint32_t chunk = min(count - sent, space);
+        copyIn(queue, (const char *) messages + (uint64_t) sent * queue->stats.messageSize, chunk);
+        sent += chunk;
+
+        queue->stats.depth += chunk;
+        queue->stats.sent += chunk;
+        if (queue->stats.depth > queue->stats.highWater) {
+            queue->stats.highWater = queue->stats.depth;
+        }
+        waitQueueWakeAll(&queue->receiveQueue);
+    }
+
+    return (int32_t) sent;
+}
+
+int32_t messageQueueReceive(int pid, int32_t id, void * messages, uint32_t capacity, uint32_t flags) {
+    MessageQueue * queue = queueOf(pid, id);
+    if (queue == NULL || (messages == NULL && capacity > 0)) {
+        return -1;
+    }
+
+    queue->stats.receiveCalls++;
+    if (capacity == 0) {
+        return 0;
+    }
+
+    while (queue->stats.depth == 0) {
+        if ((flags & MQ_NON_BLOCKING) || deferredWorkIsRunning()) {
+            return 0;
+        }
+        waitQueueSleep(&queue->receiveQueue);
+    }
+
+    uint32_t count = min(capacity, queue->stats.depth);
+    copyOut(queue, (char *) messages, count);
+    queue->stats.depth -= count;
+    queue->stats.received += count;
+
+    waitQueueWakeAll(&queue->sendQueue);
+    return (int32_t) count;
+}
+
+int32_t messageQueueStats(int pid, int32_t id, MessageQueueStats * stats) {
+    MessageQueue * queue = queueOf(pid, id);
+    if (queue == NULL || stats == NULL) {
+        return -1;
+    }
+
+    *stats = queue->stats;
+    return 0;
+}
+
+int32_t messageQueueClose(int pid, int32_t id) {
+    MessageQueue * queue = queueOf(pid, id);
+    if (queue == NULL) {
+        return -1;
+    }
+
+    if (registryClose(&registry, pid, id)) {
+        freeMemory(queue->slots);
+        queue->slots = NULL;
+    }
+    return 0;
+}
+
+void messageQueueRelease(int pid) {
+    for (int32_t id = registryNextOpened(&registry, pid, 0); id >= 0; id = registryNextOpened(&registry, pid, id + 1)) {
+        messageQueueClose(pid, id);
+    }
+}
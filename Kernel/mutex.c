@@ -0,0 +1,205 @@
+#include <mutex.h>
+#include <stddef.h>
+#include <process.h>
+#include <waitQueue.h>
+#include <registry.h>
+
+typedef struct {
+    int owner;              // pid, 0 while unlocked
+    WaitQueue queue;
+} Mutex;
+
+static Registry registry;
+static Mutex mutexes[REGISTRY_MAX_OBJECTS];
+static int32_t waitingFor[MAX_PROCESSES]; // indexed by pid - 1: id + 1 of the mutex it waits for, 0 if none
+
+// NULL unless `pid` opened mutex `id`
+static Mutex * mutexOf(int pid, int32_t id) {
+    return registryIsOpen(&registry, pid, id) ? &mutexes[id] : NULL;
+}
+
+static int32_t create(const char * name) {
+    int32_t id = registryCreate(&registry, name);
+    if (id < 0) {
+        return -1;
+    }
+
+    mutexes[id].owner = 0;
+    waitQueueInit(&mutexes[id].queue);
+    return id;
+}
+
+// Highest effective priority among the processes waiting for mutexes `pid` owns, -1 if none
+static int inheritedPriority(int pid) {
+    int inherited = -1;
+    for (int waiter = 1; waiter <= MAX_PROCESSES; waiter++) {
+        int32_t id = waitingFor[waiter - 1] - 1;
+        if (id >= 0 && mutexes[id].owner == pid && processTable[waiter - 1].effectivePriority > inherited) {
+            inherited = processTable[waiter - 1].effectivePriority;
+        }
+    }
+    return inherited;
+}
+
+void mutexRefreshPriority(int pid) {
+    // Each step follows `waitingFor` to an owner, cycles are refused by `mutexLock` but the walk stays bounded anyway
+    for (int depth = 0; depth < MAX_PROCESSES && isValidPid(pid); depth++) {
+        Process * process = &processTable[pid - 1];
+        int inherited = inheritedPriority(pid);
+        int effective = inherited > process->priority ? inherited : process->priority;
+
+        if (effective == process->effectivePriority && depth > 0) {
+            return; // the owners further up already account for it
+        }
+        setEffectivePriority(process, effective);
+
+        int32_t id = waitingFor[pid - 1] - 1;
+        if (id < 0) {
+            return;
+        }
+        pid = mutexes[id].owner;
+    }
+}
+
+int32_t mutexOpen(int pid, const char * name) {
+    if (!isValidPid(pid) || (name != NULL && name[0] == 0)) {
+        return -1;
+    }
+
+    int32_t id = registryFind(&registry, name);
+    if (id < 0) {
+        id = create(name);
+    }
+
+    if (id < 0) {
+        return -1;
+    }
+    return mutexAttach(pid, id);
+}
+
+int32_t mutexAttach(int pid, int32_t id) {
+    return registryAttach(&registry, pid, id) ? id : -1;
+}
+
+// Whether `pid` waiting for `mutex` would end up waiting for itself
+static uint8_t closesCycle(int pid, const Mutex * mutex) {
+    int owner = mutex->owner;
+    for (int depth = 0; depth < MAX_PROCESSES && isValidPid(owner); depth++) {
+        if (owner == pid) {
+            return 1;
+        }
+        int32_t id = waitingFor[owner - 1] - 1;
+        if (id < 0) {
+            return 0;
+        }
+        owner = mutexes[id].owner;
+    }
+    return 0;
+}
+
+int32_t mutexLock(int pid, int32_t id) {
+    Mutex * mutex = mutexOf(pid, id);
+    if (mutex == NULL || mutex->owner == pid) {
+        return -1;
+    }
+
+    if (mutex->owner == 0) {
+        mutex->owner = pid;
+        return 0;
+    }
+
+    if (closesCycle(pid, mutex)) {
+        return -1;
+    }
+
+    waitingFor[pid - 1] = id + 1;
+    mutexRefreshPriority(mutex->owner);
+
+    // `unlock` makes the chosen waiter the owner before waking it
+    while (mutex->owner != pid) {
+        waitQueueSleep(&mutex->queue);
+    }
+
+    waitingFor[pid - 1] = 0;
+    mutexRefreshPriority(pid); // inherits from the waiters left behind
+    return 0;
+}
+
+// Gives the mutex to its highest priority waiter (the first one among equals), or leaves it unlocked
+static void handOff(Mutex * mutex, int32_t id) {
+    int previous = mutex->owner;
+    int next = 0;
+    int nextPriority = -1;
+
+    for (uint8_t i = 0; i < mutex->queue.count; i++) {
+        int pid = mutex->queue.pids[(mutex->queue.head + i) % PROCESS_MAX_COUNT];
+        if (waitingFor[pid - 1] == id + 1 && processTable[pid - 1].effectivePriority > nextPriority) {
+            next = pid;
+            nextPriority = processTable[pid - 1].effectivePriority;
+        }
+    }
+
+    // Woken spuriously, it is out of the queue but still waiting in `mutexLock`
+    for (int pid = 1; next == 0 && pid <= MAX_PROCESSES; pid++) {
+        if (waitingFor[pid - 1] == id + 1) {
+            next = pid;
+        }
+    }
+
+    mutex->owner = next;
+    if (next != 0) {
+        waitingFor[next - 1] = 0;
+        waitQueueWake(&mutex->queue, next);
+        mutexRefreshPriority(next);
+    }
+    mutexRefreshPriority(previous);
+}
+
+int32_t mutexUnlock(int pid, int32_t id) {
+    Mutex * mutex = mutexOf(pid, id);
+    if (mutex == NULL || mutex->owner != pid) {
+        return -1;
+    }
+
+    handOff(mutex, id);
+    return 0;
+}
+
+int32_t mutexClose(int pid, int32_t id) {
+    Mutex * mutex = mutexOf(pid, id);
+    if (mutex == NULL) {
+        return -1;
+    }
+
+    if (mutex->owner == pid) {
+        handOff(mutex, id);
+    }
+
+    registryClose(&registry, pid, id);
+    return 0;
+}
+
+void mutexRelease(int pid) {
+    if (!isValidPid(pid)) {
+        return;
+    }
+
+    // Stops waiting: the owner it was boosting goes back to what it inherits from the rest
+    int32_t waited = waitingFor[pid - 1] - 1;
+    if (waited >= 0) {
+        waitingFor[pid - 1] = 0;
+        waitQueueRemove(&mutexes[waited].queue, pid);
+        mutexRefreshPriority(mutexes[waited].owner);
+    }
+
+    // The owner is the thread that locked it, the mutex may be one its process opened (and may have closed already)
+    for (int32_t id = 0; id < REGISTRY_MAX_OBJECTS; id++) {
+        if (registryExists(&registry, id) && mutexes[id].owner == pid) {
+            handOff(&mutexes[id], id);
+        }
+    }
+
+    for (int32_t id = registryNextOpened(&registry, pid, 0); id >= 0; id = registryNextOpened(&registry, pid, id + 1)) {
+        mutexClose(pid, id);
+    }
+}
@@ -0,0 +1,206 @@
+#include <pipe.h>
+#include <stddef.h>
+#include <lib.h>
+#include <MemoryManager.h>
+#include <waitQueue.h>
+#include <deferredWork.h>
+#include <process.h>
+
+typedef struct {
+    char * buffer;              // NULL when the slot is free
+    uint64_t readIndex;         // free running, the slot is `index % PIPE_BUFFER_SIZE`
+    uint64_t writeIndex;
+    uint32_t readers;           // open references to each end
+    uint32_t writers;
+    WaitQueue readQueue;
+    WaitQueue writeQueue;
+
+    // A reader blocked on an empty pipe lends its buffer: writers copy straight into it instead of into the ring
+    char * lentBuffer;
+    int lenderPid;
+    uint64_t lentCount;
+    uint64_t lentFilled;
+} Pipe;
+
+static Pipe pipes[MAX_PIPES];
+
+static Pipe * pipeOf(int id) {
+    if (id < 0 || id >= MAX_PIPES || pipes[id].buffer == NULL) {
+        return NULL;
+    }
+    return &pipes[id];
+}
+
+static uint64_t pipeUsed(const Pipe * pipe) {
+    return pipe->writeIndex - pipe->readIndex;
+}
+
+static uint64_t min(uint64_t a, uint64_t b) {
+    return a < b ? a : b;
+}
+
+// Once woken the lender takes no more bytes, the rest go to the ring
+static uint8_t lenderIsWaiting(Pipe * pipe) {
+    return pipe->lentBuffer != NULL && processTable[pipe->lenderPid - 1].blockedOn == &pipe->readQueue;
+}
+
+int pipeCreate(void) {
+    for (int id = 0; id < MAX_PIPES; id++) {
+        Pipe * pipe = &pipes[id];
+        if (pipe->buffer != NULL) {
+            continue;
+        }
+
+        pipe->buffer = allocMemory(PIPE_BUFFER_SIZE);
+        if (pipe->buffer == NULL) {
+            return -1;
+        }
+        pipe->readIndex = pipe->writeIndex = 0;
+        pipe->readers = pipe->writers = 1;
+        pipe->lentBuffer = NULL;
+        waitQueueInit(&pipe->readQueue);
+        waitQueueInit(&pipe->writeQueue);
+        return id;
+    }
+    return -1;
+}
+
+void pipeOpen(int id, PipeEnd end) {
+    Pipe * pipe = pipeOf(id);
+    if (pipe == NULL) {
+        return;
+    }
+
+    if (end == PIPE_READ_END) {
+        pipe->readers++;
+    } else {
+        pipe->writers++;
+    }
+}
+
+void pipeClose(int id, PipeEnd end) {
+    Pipe * pipe = pipeOf(id);
+    if (pipe == NULL) {
+        return;
+    }
+
+    // The other side learns about it: readers get end of file, writers stop waiting for room
+    if (end == PIPE_READ_END && pipe->readers > 0 && --pipe->readers == 0) {
+        waitQueueWakeAll(&pipe->writeQueue);
+    } else if (end == PIPE_WRITE_END && pipe->writers > 0 && --pipe->writers == 0) {
+        waitQueueWakeAll(&pipe->readQueue);
+    }
+
+    if (pipe->readers == 0 && pipe->writers == 0) {
+        freeMemory(pipe->buffer);
+        pipe->buffer = NULL;
+    }
+}
+
+int64_t pipeRead(int id, char * buffer, uint64_t count) {
+    Pipe * pipe = pipeOf(id);
+    if (pipe == NULL || buffer == NULL) {
+        return -1;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    while (pipeUsed(pipe) == 0) {
+        if (pipe->writers == 0) {
+            return 0;
+        }
+        if (deferredWorkIsRunning()) {
+            return -1;
+        }
+
+        // Only the first reader waiting lends its buffer, the rest wait for the ring
+        uint8_t lent = pipe->lentBuffer == NULL;
+        if (lent) {
+            pipe->lentBuffer = buffer;
+            pipe->lenderPid = getCurrentPid();
+            pipe->lentCount = count;
+            pipe->lentFilled = 0;
+        }
+
+        waitQueueSleep(&pipe->readQueue);
+
+        if (lent) {
+            uint64_t filled = pipe->lentFilled;
+            pipe->lentBuffer = NULL;
+            if (filled > 0) {
+                waitQueueWakeAll(&pipe->writeQueue);
+                return (int64_t) filled;
+            }
+        }
+    }
+
+    // At most two chunks: up to the end of the ring and from its start
+    uint64_t toRead = min(count, pipeUsed(pipe));
+    uint64_t offset = pipe->readIndex % PIPE_BUFFER_SIZE;
+    uint64_t first = min(toRead, PIPE_BUFFER_SIZE - offset);
+    memcpy(buffer, pipe->buffer + offset, first);
+    memcpy(buffer + first, pipe->buffer, toRead - first);
+    pipe->readIndex += toRead;
+
+    waitQueueWakeAll(&pipe->writeQueue);
+    return (int64_t) toRead;
+}
+
+uint8_t pipeReadable(int id) {
+    Pipe * pipe = pipeOf(id);
+    return pipe != NULL && (pipeUsed(pipe) > 0 || pipe->writers == 0);
+}
+
+int64_t pipeWrite(int id, const char * buffer, uint64_t count) {
+    Pipe * pipe = pipeOf(id);
+    if (pipe == NULL || (buffer == NULL && count > 0)) {
+        return -1;
+    }
+
+    uint64_t written = 0;
+    while (written < count) {
+        if (pipe->readers == 0) {
+            return written > 0 ? (int64_t) written : -1;
+        }
+
+        // Single copy into a waiting reader. Only while the ring is empty, so the bytes stay in order
+        if (lenderIsWaiting(pipe) && pipeUsed(pipe) == 0 && pipe->lentFilled < pipe->lentCount) {
+            uint64_t chunk = min(count - written, pipe->lentCount - pipe->lentFilled);
+            memcpy(pipe->lentBuffer + pipe->lentFilled, buffer + written, chunk);
+            pipe->lentFilled += chunk;
+            written += chunk;
+            waitQueueWakeAll(&pipe->readQueue);
+            continue;
+        }
+
+        uint64_t space = PIPE_BUFFER_SIZE - pipeUsed(pipe);
+        if (space == 0) {
+            if (deferredWorkIsRunning()) {
+                break;
+            }
+            waitQueueSleep(&pipe->writeQueue);
+            continue;
+        }
+
+        uint64_t chunk = min(count - written, space);
+        uint64_t offset = pipe->writeIndex % PIPE_BUFFER_SIZE;
+        uint64_t first = min(chunk, PIPE_BUFFER_SIZE - offset);
+        memcpy(pipe->buffer + offset, buffer + written, first);
+        memcpy(pipe->buffer, buffer + written + first, chunk - first);
+        pipe->writeIndex += chunk;
+        written += chunk;
+
+        waitQueueWakeAll(&pipe->readQueue);
+    }
+
+    return (int64_t) written;
+}
+
+void pipeForgetProcess(int pid) {
+    for (int id = 0; id < MAX_PIPES; id++) {
+        if (pipes[id].buffer != NULL && pipes[id].lentBuffer != NULL && pipes[id].lenderPid == pid) {
+            pipes[id].lentBuffer = NULL;
+        }
+    }
+}
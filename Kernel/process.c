@@ -9,6 +9,15 @@
 #include "interrupts.h"
 #include "lib.h"
 #include "process_info.h"
+#include "ioRing.h"
+#include "trace.h"
+#include "deferredWork.h"
+#include "waitQueue.h"
+#include "pipe.h"
+#include "sharedMemory.h"
+#include "semaphore.h"
+#include "mutex.h"
+#include "messageQueue.h"
 
 int currentPid = 0; // el primer proceso current va a ser el primero en inicializarse
 int availableProcesses = 0;
@@ -27,30 +36,135 @@ void initProcessSystem(void)
         processTable[i].stackSize = 0;
         processTable[i].next = NULL;
         processTable[i].priority = MIN_PRIORITY;
+        processTable[i].effectivePriority = MIN_PRIORITY;
         processTable[i].ctx = 0;
+        processTable[i].parentPid = 0;
+        processTable[i].waitingFor = 0;
+        processTable[i].blockedOn = NULL;
+        processTable[i].processGroup = 0;
+        processTable[i].ownerPid = 0;
     }
     availableProcesses = MAX_PROCESSES;
     currentPid = 0;
     initScheduler();
 }
 
-Process *createProcess(char *name, void (*Entry)(void *), char **Argv, int Argc, void *StackBase, size_t StackSize, bool isForeground)
+// pids are the table index + 1
+bool isValidPid(int pid)
 {
-    if (Entry == NULL)
+    return pid > 0 && pid <= MAX_PROCESSES;
+}
+
+static Process *findProcess(int pid)
+{
+    if (!isValidPid(pid) || processTable[pid - 1].pid != pid)
         return NULL;
+    return &processTable[pid - 1];
+}
 
-    // busco slot libre
-    int slot = -1;
-    //! despues habria que crear la funcion getAvailableSlot... dbpp
+// Finished threads give their stacks back here, creating a thread only allocates when the pool is empty
+static void *threadStackPool[MAX_PROCESSES];
+static int threadStackPoolCount = 0;
+
+static void *takeThreadStack(void)
+{
+    if (threadStackPoolCount > 0)
+        return threadStackPool[--threadStackPoolCount];
+    return allocMemory(THREAD_STACK_SIZE);
+}
+
+static void returnThreadStack(void *stack)
+{
+    if (threadStackPoolCount < MAX_PROCESSES)
+        threadStackPool[threadStackPoolCount++] = stack;
+    else
+        freeMemory(stack);
+}
+
+static bool isThread(const Process *p)
+{
+    return p->ownerPid != p->pid;
+}
+
+static int availableSlot(void)
+{
     for (int i = 0; i < MAX_PROCESSES; i++)
     {
         if (processTable[i].state == TERMINATED || processTable[i].pid == 0)
-        {
-            slot = i;
-            break;
-        }
+            return i;
+    }
+    return -1;
+}
+
+// Frees everything a finished process still holds, its slot can be reused afterwards
+static void releaseProcess(Process *p)
+{
+    if (p->stackBase && isThread(p))
+        returnThreadStack(p->stackBase);
+    else if (p->stackBase)
+        freeMemory(p->stackBase);
+    p->stackBase = NULL;
+    p->stackSize = 0;
+    p->entry = NULL;
+    p->Arg = NULL;
+    p->name = NULL;
+    p->state = TERMINATED;
+    p->pid = 0;
+    p->ownerPid = 0;
+    p->parentPid = 0;
+    p->waitingFor = 0;
+    availableProcesses++;
+}
+
+// Copies the name and the argument strings to the top of the new stack, followed by a NULL terminated argv
+// The process owns its arguments from then on, whatever happens to the caller's buffers
+// Returns the new stack top (16 byte aligned), or NULL if they do not fit in PROCESS_ARGS_MAX_SIZE
+static uint8_t *packArguments(uint8_t *stackTop, const char *name, char **argv, int argc, char **packedName, char ***packedArgv)
+{
+    uint64_t stringsSize = 0;
+    for (const char *c = name; *c; c++)
+        stringsSize++;
+    stringsSize++;
+    for (int i = 0; i < argc; i++)
+    {
+        for (const char *c = argv[i]; *c; c++)
+            stringsSize++;
+        stringsSize++;
     }
 
+    uint64_t stringsArea = (stringsSize + 15) & ~(uint64_t)15;
+    uint64_t argvArea = (((uint64_t)argc + 1) * sizeof(char *) + 15) & ~(uint64_t)15;
+    if (stringsArea + argvArea > PROCESS_ARGS_MAX_SIZE)
+        return NULL;
+
+    char *strings = (char *)(stackTop - stringsArea);
+    char **packed = (char **)(stackTop - stringsArea - argvArea);
+
+    *packedName = strings;
+    for (const char *c = name; *c; c++)
+        *strings++ = *c;
+    *strings++ = 0;
+
+    for (int i = 0; i < argc; i++)
+    {
+        packed[i] = strings;
+        for (const char *c = argv[i]; *c; c++)
+            *strings++ = *c;
+        *strings++ = 0;
+    }
+    packed[argc] = NULL;
+
+    *packedArgv = packed;
+    return (uint8_t *)packed;
+}
+
+Process *createProcess(char *name, void (*Entry)(void *), char **Argv, int Argc, void *StackBase, size_t StackSize, bool isForeground)
+{
+    if (Entry == NULL || name == NULL || Argc < 0 || Argc > PROCESS_MAX_ARGS || (Argc > 0 && Argv == NULL))
+        return NULL;
+
+    // busco slot libre
+    int slot = availableSlot();
     if (slot < 0)
         return NULL;
 
@@ -59,11 +173,14 @@ Process *createProcess(char *name, void (*Entry)(void *), char **Argv, int Argc,
     p->pid = slot + 1; /* pid simple: índice+1 */
     p->state = READY;
     p->entry = Entry;
-    p->Arg = Argv;
     p->next = NULL;
     p->priority = MIN_PRIORITY;
-    p->name = name;
+    p->effectivePriority = MIN_PRIORITY;
     p->isForeground = isForeground;
+    p->parentPid = currentPid;
+    p->exitCode = 0;
+    p->waitingFor = 0;
+    p->blockedOn = NULL;
 
     size_t sz = (StackSize > 0) ? StackSize : PROCESS_STACK_SIZE;
     void *stk = allocMemory(sz);
@@ -77,18 +194,43 @@ Process *createProcess(char *name, void (*Entry)(void *), char **Argv, int Argc,
     p->stackBase = stk;
     p->stackSize = sz;
 
+    uint8_t *stackTop = packArguments((uint8_t *)p->stackBase + p->stackSize, name, Argv, Argc, &p->name, &p->Arg);
+    if (stackTop == NULL)
+    {
+        freeMemory(stk);
+        p->stackBase = NULL;
+        p->stackSize = 0;
+        p->pid = 0;
+        p->state = TERMINATED;
+        return NULL;
+    }
+
+    Process *parent = getCurrentProcess();
+    fdTableInit(p->fds, parent != NULL ? getOwnerProcess(parent)->fds : NULL);
+
+    // A new program: nothing pending and default actions, handlers would point into the parent's code
+    p->ownerPid = p->pid;
+    p->processGroup = parent != NULL ? parent->processGroup : p->pid;
+    p->pendingSignals = 0;
+    p->blockedSignals = 0;
+    for (int i = 0; i < SIGNAL_COUNT; i++)
+        p->signalHandlers[i] = SIG_DFL;
+
     if (availableProcesses > 0)
         availableProcesses--;
     // Contexto inicial: usamos contextSwitchTo (mov rsp, ctx; ret).
     // Por lo tanto, ctx debe apuntar a una pila cuyo tope contenga la
     // dirección de retorno. Esa dirección será nuestro trampolín.
-    uint8_t *stackTop = (uint8_t *)p->stackBase + p->stackSize;
     // stackTop = (uint8_t *)(((uintptr_t)stackTop) & ~((uintptr_t)0xF));
     // StackFrame *frame = (StackFrame *)(stackTop - sizeof(StackFrame));
 
     // memset(frame, 0, sizeof(StackFrame));
 
-    uint8_t *readyRsp = stackInit(stackTop, (void *)Entry, Argc, Argv);
+    // Si Entry retorna, lo hace al trampolín, que termina el proceso con el valor devuelto
+    stackTop -= sizeof(uint64_t);
+    *(uint64_t *)stackTop = (uint64_t)&processExitTrampoline;
+
+    uint8_t *readyRsp = stackInit(stackTop, (void *)Entry, Argc, p->Arg);
 
     // frame->rip = (uint64_t)&processBootstrap;
     // frame->cs = KERNEL_CS;
@@ -98,71 +240,151 @@ Process *createProcess(char *name, void (*Entry)(void *), char **Argv, int Argc,
 
     p->ctx = (uint64_t)readyRsp;
 
+    TRACE(TRACE_PROCESS_CREATE, p->pid, Entry);
     schedulerAddProcess(p);
 
     return p;
 }
 
-void exitCurrentProcess(int exitCode)
+// Leaves `p` as a ZOMBIE: off the ready queue, with its exit code, and wakes its parent if it is waiting for it
+static void terminateProcess(Process *p, int exitCode)
 {
-    (void)exitCode;
-    int pid = getCurrentPid();
-    if (pid <= 0)
-        return;
+    if (p->state == READY)
+        unschedule(p);
+    ioRingRelease(p->pid);
+    sharedMemoryRelease(p->pid);
+    semaphoreRelease(p->pid);
+    mutexRelease(p->pid);
+    messageQueueRelease(p->pid);
+    waitQueueRemove(p->blockedOn, p->pid);
+    p->blockedOn = NULL;
+    pipeForgetProcess(p->pid);
+    fdTableRelease(p->fds);
+    p->exitCode = exitCode;
+    p->state = ZOMBIE;
+    p->waitingFor = 0;
+
+    // Its threads go with it, the descriptors they used were just closed
+    for (int i = 0; i < MAX_PROCESSES && !isThread(p); i++)
+    {
+        Process *thread = &processTable[i];
+        if (thread->pid != 0 && thread != p && thread->ownerPid == p->pid && thread->state != ZOMBIE)
+            terminateProcess(thread, exitCode);
+    }
 
+    // Its children become orphans, the ones that already finished are not waited for anymore
     for (int i = 0; i < MAX_PROCESSES; i++)
     {
-        if (processTable[i].pid == pid)
+        Process *child = &processTable[i];
+        if (child->pid != 0 && child->parentPid == p->pid)
         {
-            // si uso stack, lo libero
-            if (processTable[i].stackBase)
-            {
-                freeMemory(processTable[i].stackBase);
-                processTable[i].stackBase = NULL;
-                processTable[i].stackSize = 0;
-            }
-            processTable[i].entry = NULL;
-            processTable[i].Arg = NULL;
-            processTable[i].state = TERMINATED;
-            processTable[i].pid = 0;
-            availableProcesses++;
-            currentPid = 0;
-            return;
+            child->parentPid = 0;
+            if (child->state == ZOMBIE)
+                releaseProcess(child);
         }
     }
+
+    Process *parent = findProcess(p->parentPid);
+    if (parent == NULL || parent->state == ZOMBIE)
+    {
+        p->parentPid = 0;
+        // The running process is still on its stack, the scheduler releases it after switching away
+        if (p != getCurrentProcess())
+            releaseProcess(p);
+        return;
+    }
+
+    if (parent->state == BLOCKED && parent->waitingFor == p->pid)
+    {
+        parent->waitingFor = 0;
+        parent->state = READY;
+        schedulerAddProcess(parent);
+        TRACE(TRACE_UNBLOCK, parent->pid, 0);
+    }
+}
+
+void exitCurrentProcess(int exitCode)
+{
+    _cli();
+
+    Process *p = getCurrentProcess();
+    if (p != NULL && p->state != ZOMBIE)
+    {
+        TRACE(TRACE_PROCESS_EXIT, p->pid, exitCode);
+        terminateProcess(p, exitCode);
+    }
+
+    // Nothing left to run here: switch away now, a ZOMBIE is never picked again
+    while (1)
+        _yield();
 }
 
 int killProcess(int pid)
 {
-    if (pid <= 0)
+    return killProcessWithExitCode(pid, PROCESS_KILLED_EXIT_CODE);
+}
+
+int killProcessWithExitCode(int pid, int exitCode)
+{
+    Process *p = findProcess(pid);
+    if (p == NULL || p->state == ZOMBIE)
         return -1;
-    for (int i = 0; i < MAX_PROCESSES; i++)
+
+    TRACE(TRACE_PROCESS_KILL, pid, exitCode);
+    terminateProcess(p, exitCode);
+    return 0;
+}
+
+int setProcessGroup(int pid, int group)
+{
+    Process *caller = getCurrentProcess();
+    Process *p = pid == 0 ? caller : findProcess(pid);
+    if (caller == NULL || p == NULL || p->state == ZOMBIE || group < 0)
+        return -1;
+
+    if (p != caller && p->parentPid != caller->pid)
+        return -1;
+
+    p->processGroup = group == 0 ? p->pid : group;
+    return 0;
+}
+
+int waitProcess(int pid, int *exitCode, int options)
+{
+    Process *parent = getCurrentProcess();
+    Process *child = findProcess(pid);
+    if (parent == NULL || child == NULL || child == parent || child->parentPid != parent->pid)
+        return -1;
+
+    if (child->state != ZOMBIE && (options & WAIT_NO_HANG))
+        return 0;
+
+    while (child->state != ZOMBIE)
     {
-        if (processTable[i].pid == pid)
-        {
-            if (processTable[i].state == READY)
-            {
-                unschedule(&processTable[i]);
-            }
-            if (processTable[i].stackBase)
-            {
-                freeMemory(processTable[i].stackBase);
-                processTable[i].stackBase = NULL;
-                processTable[i].stackSize = 0;
-            }
-            processTable[i].entry = NULL;
-            processTable[i].Arg = NULL;
-            processTable[i].state = TERMINATED;
-            processTable[i].pid = 0;
-            availableProcesses++;
-            if (currentPid == pid)
-            {
-                currentPid = 0;
-            }
-            return 0;
-        }
+        parent->waitingFor = pid;
+        parent->state = BLOCKED;
+        TRACE(TRACE_BLOCK, parent->pid, pid);
+        _yield(); // the child's exit makes the parent READY again
+        _cli();
     }
-    return -1;
+
+    if (exitCode != NULL)
+        *exitCode = child->exitCode;
+    releaseProcess(child);
+    return pid;
+}
+
+static void releaseOrphanZombie(uint64_t pid)
+{
+    Process *p = findProcess((int)pid);
+    if (p != NULL && p->state == ZOMBIE && p->parentPid == 0 && p != getCurrentProcess())
+        releaseProcess(p);
+}
+
+void releaseIfOrphanZombie(Process *process)
+{
+    if (process->pid != 0 && process->state == ZOMBIE && process->parentPid == 0)
+        queueDeferredWork(releaseOrphanZombie, process->pid);
 }
 
 int toggleProcessBlock(int pid)
@@ -183,6 +405,7 @@ int toggleProcessBlock(int pid)
         {
             unschedule(process);
             process->state = BLOCKED;
+            TRACE(TRACE_BLOCK, pid, 0);
             return BLOCKED;
         }
 
@@ -190,6 +413,7 @@ int toggleProcessBlock(int pid)
         {
             process->state = READY;
             schedulerAddProcess(process);
+            TRACE(TRACE_UNBLOCK, pid, 0);
             return READY;
         }
 
@@ -215,34 +439,116 @@ int setProcessPriority(int pid, int priority)
     {
         Process *p = &processTable[i];
 
-        if (p->pid != pid || p->state == TERMINATED)
+        if (p->pid != pid || p->state == TERMINATED || p->state == ZOMBIE)
         {
             continue;
         }
 
-        if (p->priority == priority)
-        {
-            return 0;
-        }
+        p->priority = priority;
+        mutexRefreshPriority(pid); // keeps what it inherits from the waiters of its mutexes
 
-        bool wasReady = (p->state == READY);
+        return 0;
+    }
 
-        if (wasReady)
-        {
-            unschedule(p);
-        }
+    return -1;
+}
 
-        p->priority = priority;
+void setEffectivePriority(Process *p, int priority)
+{
+    if (p->effectivePriority == priority)
+        return;
 
-        if (wasReady)
-        {
-            schedulerAddProcess(p);
-        }
+    bool wasReady = (p->state == READY);
 
-        return 0;
+    if (wasReady)
+    {
+        unschedule(p);
     }
 
-    return -1;
+    p->effectivePriority = priority;
+
+    if (wasReady)
+    {
+        schedulerAddProcess(p);
+    }
+}
+
+Process *createThread(int (*Entry)(void *), void *arg)
+{
+    Process *creator = getCurrentProcess();
+    int slot = availableSlot();
+    if (Entry == NULL || creator == NULL || slot < 0)
+        return NULL;
+
+    void *stack = takeThreadStack();
+    if (stack == NULL)
+        return NULL;
+
+    Process *owner = getOwnerProcess(creator);
+    Process *t = &processTable[slot];
+    t->pid = slot + 1;
+    t->ownerPid = owner->pid;
+    t->state = READY;
+    t->entry = (void (*)(void *))Entry;
+    t->Arg = NULL;
+    t->name = owner->name;
+    t->next = NULL;
+    t->priority = creator->priority;
+    t->effectivePriority = creator->priority;
+    t->isForeground = creator->isForeground;
+    t->parentPid = creator->pid; // the one that joins it
+    t->exitCode = 0;
+    t->waitingFor = 0;
+    t->blockedOn = NULL;
+    t->stackBase = stack;
+    t->stackSize = THREAD_STACK_SIZE;
+
+    // Same code as the creator: same handlers, but its own pending and blocked signals
+    t->processGroup = creator->processGroup;
+    t->pendingSignals = 0;
+    t->blockedSignals = 0;
+    for (int i = 0; i < SIGNAL_COUNT; i++)
+        t->signalHandlers[i] = creator->signalHandlers[i];
+
+    // Never used: descriptor operations go to the owner's table
+    for (int fd = 0; fd < PROCESS_MAX_FDS; fd++)
+        t->fds[fd].type = FD_CLOSED;
+
+    if (availableProcesses > 0)
+        availableProcesses--;
+
+    uint8_t *stackTop = (uint8_t *)stack + THREAD_STACK_SIZE;
+    stackTop -= sizeof(uint64_t);
+    *(uint64_t *)stackTop = (uint64_t)&processExitTrampoline;
+
+    StackFrame *frame = (StackFrame *)stackInit(stackTop, (void *)Entry, 0, NULL);
+    frame->rdi = (uint64_t)arg; // `stackInit` passes (argc, argv), a thread gets its one argument
+    t->ctx = (uint64_t)frame;
+
+    TRACE(TRACE_PROCESS_CREATE, t->pid, Entry);
+    schedulerAddProcess(t);
+    return t;
+}
+
+int joinThread(int tid, int *exitCode)
+{
+    Process *t = findProcess(tid);
+    if (t == NULL || !isThread(t))
+        return -1;
+    return waitProcess(tid, exitCode, 0);
+}
+
+Process *getOwnerProcess(Process *p)
+{
+    if (p == NULL || !isThread(p))
+        return p;
+    return &processTable[p->ownerPid - 1];
+}
+
+int getOwnerPid(int pid)
+{
+    Process *p = findProcess(pid);
+    return p == NULL ? pid : p->ownerPid;
 }
 
 Process *getCurrentProcess()
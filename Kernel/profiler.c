@@ -0,0 +1,54 @@
+#include <profiler.h>
+#include <process.h>
+#include <lib.h>
+#include <stddef.h>
+
+#define SYMBOL_TABLE_MAX_LENGTH 0x100000 // the module slot, up to the next one
+
+static volatile uint8_t enabled = 0;
+static ProfileSample samples[PROFILER_MAX_SAMPLES];
+static uint32_t sampleCount = 0;
+
+static const char * symbols = NULL;
+static uint64_t symbolsLength = 0;
+
+void initProfiler(const char * symbolTable) {
+    symbols = symbolTable;
+    symbolsLength = 0;
+    while (symbolsLength < SYMBOL_TABLE_MAX_LENGTH && symbolTable[symbolsLength] != 0) {
+        symbolsLength++;
+    }
+}
+
+void profilerStart(void) {
+    enabled = 0;
+    sampleCount = 0;
+    enabled = 1;
+}
+
+void profilerStop(void) {
+    enabled = 0;
+}
+
+void profilerSample(uint64_t savedContext) {
+    if (!enabled || sampleCount >= PROFILER_MAX_SAMPLES) {
+        return;
+    }
+
+    const StackFrame * frame = (const StackFrame *) savedContext;
+    samples[sampleCount].rip = frame->rip;
+    samples[sampleCount].pid = currentPid;
+    samples[sampleCount].reserved = 0;
+    sampleCount++;
+}
+
+uint32_t profilerRead(ProfileSample * buffer, uint32_t capacity) {
+    uint32_t count = capacity < sampleCount ? capacity : sampleCount;
+    memcpy(buffer, samples, count * sizeof(ProfileSample));
+    return count;
+}
+
+uint64_t getSymbolTable(const char ** table) {
+    *table = symbols;
+    return symbolsLength;
+}
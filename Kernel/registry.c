@@ -0,0 +1,75 @@
+#include <registry.h>
+#include <stddef.h>
+#include <lib.h>
+#include <process.h>
+
+int32_t registryFind(const Registry * registry, const char * name) {
+    for (int32_t id = 0; name != NULL && id < REGISTRY_MAX_OBJECTS; id++) {
+        if (registry->used[id] && registry->names[id][0] != 0 && namesEqual(registry->names[id], name, REGISTRY_NAME_LENGTH)) {
+            return id;
+        }
+    }
+    return -1;
+}
+
+int32_t registryCreate(Registry * registry, const char * name) {
+    for (int32_t id = 0; id < REGISTRY_MAX_OBJECTS; id++) {
+        if (registry->used[id]) {
+            continue;
+        }
+
+        if (name == NULL) {
+            registry->names[id][0] = 0;
+        } else if (!copyName(registry->names[id], name, REGISTRY_NAME_LENGTH)) {
+            return -1;
+        }
+
+        registry->used[id] = 1;
+        registry->references[id] = 0;
+        return id;
+    }
+    return -1;
+}
+
+uint8_t registryExists(const Registry * registry, int32_t id) {
+    return id >= 0 && id < REGISTRY_MAX_OBJECTS && registry->used[id];
+}
+
+uint8_t registryAttach(Registry * registry, int pid, int32_t id) {
+    pid = getOwnerPid(pid); // threads use what their process opened
+    if (!isValidPid(pid) || !registryExists(registry, id)) {
+        return 0;
+    }
+
+    if (!(registry->opened[pid - 1] & (1u << id))) {
+        registry->opened[pid - 1] |= 1u << id;
+        registry->references[id]++;
+    }
+    return 1;
+}
+
+uint8_t registryIsOpen(const Registry * registry, int pid, int32_t id) {
+    pid = getOwnerPid(pid); // threads use what their process opened
+    return isValidPid(pid) && registryExists(registry, id) && (registry->opened[pid - 1] & (1u << id));
+}
+
+uint8_t registryClose(Registry * registry, int pid, int32_t id) {
+    pid = getOwnerPid(pid); // threads use what their process opened
+    registry->opened[pid - 1] &= ~(1u << id);
+    if (--registry->references[id] > 0) {
+        return 0;
+    }
+
+    registry->used[id] = 0;
+    registry->names[id][0] = 0;
+    return 1;
+}
+
+int32_t registryNextOpened(const Registry * registry, int pid, int32_t id) {
+    for (; isValidPid(pid) && id >= 0 && id < REGISTRY_MAX_OBJECTS; id++) {
+        if (registry->opened[pid - 1] & (1u << id)) {
+            return id;
+        }
+    }
+    return -1;
+}
@@ -6,6 +6,10 @@
 #include <string.h>
 
 #include "process.h"
+#include "time.h"
+#include "deferredWork.h"
+#include "trace.h"
+#include "signal.h"
 
 int countReadyQueue[MAX_PRIORITIES];
 processQueue readyQueue[MAX_PRIORITIES];
@@ -71,12 +75,17 @@ void schedulerAddProcess(Process* process) {
         return;
     }
 
-    int priority = normalizePriority(process->priority);
+    int priority = normalizePriority(process->effectivePriority);
     enqueueReady(&readyQueue[priority], process);
     countReadyQueue[priority]++;
 }
 
 uint64_t schedule(uint64_t savedContext) {
+    // Deferred work runs on the interrupted process' stack, it is finished before switching away
+    if (deferredWorkIsRunning()) {
+        return savedContext;
+    }
+
     Process* running = currentProcess;
 
     if (running != NULL && savedContext != 0) {
@@ -94,14 +103,23 @@ uint64_t schedule(uint64_t savedContext) {
     if (next == NULL) {
         currentProcess = NULL;
         currentPid = 0;
+        setKernelDataPid(0);
         return savedContext;
     }
 
+    if (next != running) {
+        TRACE(TRACE_SWITCH, next->pid, 0);
+        if (running != NULL) {
+            releaseIfOrphanZombie(running); // its stack is no longer in use
+        }
+    }
+
     next->state = RUNNING;
     currentProcess = next;
     currentPid = next->pid;
+    setKernelDataPid(next->pid);
 
-    return next->ctx;
+    return signalDeliver(next); // a pending handler runs before the code it was interrupted in
 }
 
 //! Analizar si doy mas prioridad a 0 que a 3 o viceversa. busca de mayor a menor prioridad. Devuelve el primero en la lista de la primer prioridad no vacia
@@ -131,7 +149,7 @@ void unschedule(Process* process) {
         return;
     }
 
-    int priority = normalizePriority(process->priority);
+    int priority = normalizePriority(process->effectivePriority);
     processQueue* queue = &readyQueue[priority];
 
     Process* prev = NULL;
@@ -162,3 +180,9 @@ void unschedule(Process* process) {
         countReadyQueue[priority]--;
     }
 }
+
+// The process stays RUNNING, so `schedule` puts it at the back of its ready queue right away
+void schedulerOnYield(void) {
+    _yield();
+    _cli();
+}
@@ -0,0 +1,219 @@
+/**
+ * Note: Paging redraws the whole screen from the cell store, it is compiled with -O3 alongside `fonts.c`.
+ */
+
+#include <scrollback.h>
+#include <fonts.h>
+#include <keyboard.h>
+#include <video.h>
+
+#define BASE_GLYPH_WIDTH DEFAULT_GLYPH_SIZE_X
+
+// `scale` 0 marks a cell that is empty or covered by a bigger glyph on its left
+typedef struct {
+    uint32_t foreground;
+    uint32_t background;
+    char ascii;
+    uint8_t scale;
+} Cell;
+
+typedef struct {
+    uint16_t height; // pixels the cursor moved down when the line ended
+    Cell cells[SCROLLBACK_COLUMNS];
+} Line;
+
+// Ring of lines, line `n` lives in `lines[n % SCROLLBACK_LINES]`
+static Line lines[SCROLLBACK_LINES];
+static uint64_t current;        // line the cursor is on
+static uint64_t liveTop;        // first line of the live screen, lines before it were cleared
+static uint64_t offset;         // lines the view is moved up, 0 when showing the live screen
+
+static const char historyLabel[] = "[history]";
+
+static inline Line * lineAt(uint64_t n) {
+    return &lines[n % SCROLLBACK_LINES];
+}
+
+static inline uint64_t oldestLine(void) {
+    return current >= SCROLLBACK_LINES - 1 ? current - (SCROLLBACK_LINES - 1) : 0;
+}
+
+static void resetLine(uint64_t n, uint16_t height) {
+    Line * line = lineAt(n);
+    line->height = height;
+    for (uint16_t i = 0; i < SCROLLBACK_COLUMNS; i++) {
+        line->cells[i].scale = 0;
+    }
+}
+
+static void handlePageUp(enum KEYS scancode) {
+    if (isShiftPressed() && isExtendedKey()) scrollbackPageUp();
+}
+
+static void handlePageDown(enum KEYS scancode) {
+    if (isShiftPressed() && isExtendedKey()) scrollbackPageDown();
+}
+
+void initScrollback(void) {
+    current = liveTop = offset = 0;
+    resetLine(0, DEFAULT_GLYPH_SIZE_Y * getFontSize());
+    registerSpecialKey(KP_PAGE_UP_KEY, handlePageUp, 1);
+    registerSpecialKey(KP_PAGE_DOWN_KEY, handlePageDown, 1);
+}
+
+void scrollbackPutGlyph(char ascii, uint64_t x, uint8_t scale, uint32_t foreground, uint32_t background) {
+    uint64_t column = x / BASE_GLYPH_WIDTH;
+    if (scale == 0 || column >= SCROLLBACK_COLUMNS) return;
+
+    Cell * cells = lineAt(current)->cells;
+    cells[column] = (Cell) { .foreground = foreground, .background = background, .ascii = ascii, .scale = scale };
+    for (uint64_t i = column + 1; i < column + scale && i < SCROLLBACK_COLUMNS; i++) {
+        cells[i].scale = 0;
+    }
+}
+
+// `height` is how far the cursor moved down, `nextHeight` the starting height of the new line
+void scrollbackNewLine(uint16_t height, uint16_t nextHeight) {
+    lineAt(current)->height = height;
+    current++;
+    resetLine(current, nextHeight);
+}
+
+void scrollbackPreviousLine(void) {
+    if (current > liveTop && current > oldestLine()) {
+        current--;
+    }
+}
+
+void scrollbackClear(void) {
+    offset = 0;
+    scrollbackNewLine(lineAt(current)->height, DEFAULT_GLYPH_SIZE_Y * getFontSize());
+    liveTop = current;
+}
+
+// Consecutive glyphs sharing scale and colors are drawn as a single run
+static void drawRecordedLine(const Line * line, uint64_t y) {
+    char run[SCROLLBACK_COLUMNS];
+    uint16_t column = 0;
+
+    while (column < SCROLLBACK_COLUMNS) {
+        const Cell * first = &line->cells[column];
+        if (first->scale == 0) {
+            column++;
+            continue;
+        }
+
+        uint16_t start = column;
+        uint64_t length = 0;
+        uint8_t scale = first->scale;
+
+        while (1) {
+            run[length++] = line->cells[column].ascii;
+
+            // The run continues only if the glyph was not partially overwritten and the next one matches
+            uint16_t next = column + scale, i = column + 1;
+            while (i < next && i < SCROLLBACK_COLUMNS && line->cells[i].scale == 0) i++;
+            if (i != next || next >= SCROLLBACK_COLUMNS) break;
+
+            const Cell * cell = &line->cells[next];
+            if (cell->scale != scale || cell->foreground != first->foreground || cell->background != first->background) break;
+            column = next;
+        }
+
+        drawTextRun(run, length, start * BASE_GLYPH_WIDTH, y, scale, first->foreground, first->background);
+        column++;
+    }
+}
+
+// Same layout as the live screen: the cursor line at its current position, older lines stacked above it
+static void drawLive(void) {
+    fillVideoMemory(DEFAULT_BACKGROUND_COLOR);
+
+    uint64_t first = liveTop > oldestLine() ? liveTop : oldestLine();
+    int64_t y = getYBufferPosition();
+
+    for (uint64_t n = current; y >= 0; n--) {
+        drawRecordedLine(lineAt(n), y);
+        if (n == first) break;
+        y -= lineAt(n - 1)->height;
+    }
+}
+
+// Line `current - offset` at the bottom of the screen, as many older lines as fit above it
+static void drawHistory(void) {
+    fillVideoMemory(DEFAULT_BACKGROUND_COLOR);
+
+    uint64_t oldest = oldestLine();
+    int64_t y = getWindowHeight();
+
+    for (uint64_t n = current - offset; ; n--) {
+        y -= lineAt(n)->height;
+        if (y < 0) break;
+        drawRecordedLine(lineAt(n), y);
+        if (n == oldest) break;
+    }
+
+    uint64_t labelWidth = (sizeof(historyLabel) - 1) * BASE_GLYPH_WIDTH;
+    printAt(historyLabel, sizeof(historyLabel) - 1, getWindowWidth() - labelWidth, 0, DEFAULT_BACKGROUND_COLOR, DEFAULT_TEXT_COLOR);
+}
+
+// Lines that fit on the screen with `bottom` as the last one
+static uint64_t linesPerPage(uint64_t bottom) {
+    uint64_t oldest = oldestLine(), count = 0;
+    int64_t y = getWindowHeight();
+
+    for (uint64_t n = bottom; ; n--) {
+        y -= lineAt(n)->height;
+        if (y < 0) break;
+        count++;
+        if (n == oldest) break;
+    }
+
+    return count == 0 ? 1 : count;
+}
+
+// Largest offset, the one that shows the oldest line at the top of the screen
+static uint64_t maxOffset(void) {
+    uint64_t bottom = oldestLine();
+    int64_t y = getWindowHeight() - lineAt(bottom)->height;
+
+    while (bottom < current && y - lineAt(bottom + 1)->height >= 0) {
+        bottom++;
+        y -= lineAt(bottom)->height;
+    }
+
+    return current - bottom;
+}
+
+void scrollbackPageUp(void) {
+    uint64_t limit = maxOffset();
+    if (offset >= limit) return;
+
+    offset += linesPerPage(current - offset);
+    if (offset > limit) offset = limit;
+    drawHistory();
+}
+
+void scrollbackPageDown(void) {
+    if (offset == 0) return;
+
+    uint64_t page = linesPerPage(current - offset);
+    offset = offset > page ? offset - page : 0;
+    if (offset == 0) {
+        drawLive();
+    } else {
+        drawHistory();
+    }
+}
+
+uint8_t scrollbackIsPaging(void) {
+    return offset != 0;
+}
+
+// Goes back to the live screen, output always lands there
+void scrollbackFollow(void) {
+    if (offset != 0) {
+        offset = 0;
+        drawLive();
+    }
+}
@@ -0,0 +1,139 @@
+#include <semaphore.h>
+#include <stddef.h>
+#include <process.h>
+#include <waitQueue.h>
+#include <registry.h>
+
+typedef struct {
+    uint32_t wakeups;       // posts that found nobody asleep, taken by the next waiter to enter the kernel
+    uint32_t granted;       // processes woken by a post that did not take their unit yet, bit pid - 1
+    WaitQueue queue;
+} Semaphore;
+
+static Registry registry;
+static Semaphore semaphores[REGISTRY_MAX_OBJECTS];
+static volatile int32_t counters[REGISTRY_MAX_OBJECTS]; // the part userland sees
+
+// NULL unless `pid` opened semaphore `id`
+static Semaphore * semaphoreOf(int pid, int32_t id) {
+    return registryIsOpen(&registry, pid, id) ? &semaphores[id] : NULL;
+}
+
+static int32_t create(const char * name, int32_t value) {
+    int32_t id = registryCreate(&registry, name);
+    if (id < 0) {
+        return -1;
+    }
+
+    semaphores[id].wakeups = 0;
+    semaphores[id].granted = 0;
+    waitQueueInit(&semaphores[id].queue);
+    counters[id] = value;
+    return id;
+}
+
+int32_t semaphoreOpen(int pid, const char * name, int32_t value, volatile int32_t ** counter) {
+    if (!isValidPid(pid) || counter == NULL || value < 0 || (name != NULL && name[0] == 0)) {
+        return -1;
+    }
+
+    int32_t id = registryFind(&registry, name);
+    if (id < 0) {
+        id = create(name, value);
+    }
+
+    if (id < 0 || semaphoreAttach(pid, id, counter) < 0) {
+        return -1;
+    }
+    return id;
+}
+
+int32_t semaphoreAttach(int pid, int32_t id, volatile int32_t ** counter) {
+    if (counter == NULL || !registryAttach(&registry, pid, id)) {
+        return -1;
+    }
+
+    *counter = &counters[id];
+    return id;
+}
+
+int32_t semaphoreWait(int pid, int32_t id) {
+    Semaphore * semaphore = semaphoreOf(pid, id);
+    if (semaphore == NULL) {
+        return -1;
+    }
+
+    uint32_t self = 1u << (pid - 1);
+    while (1) {
+        if (semaphore->granted & self) {
+            semaphore->granted &= ~self;
+            return 0;
+        }
+        // Its post came in between the decrement in userland and this call
+        if (semaphore->wakeups > 0) {
+            semaphore->wakeups--;
+            return 0;
+        }
+        waitQueueSleep(&semaphore->queue);
+    }
+}
+
+static void handOff(Semaphore * semaphore) {
+    int woken = waitQueueWakeOne(&semaphore->queue);
+    if (woken > 0) {
+        semaphore->granted |= 1u << (woken - 1);
+    } else {
+        semaphore->wakeups++;
+    }
+}
+
+int32_t semaphorePost(int pid, int32_t id) {
+    Semaphore * semaphore = semaphoreOf(pid, id);
+    if (semaphore == NULL) {
+        return -1;
+    }
+
+    handOff(semaphore);
+    return 0;
+}
+
+int32_t semaphoreClose(int pid, int32_t id) {
+    if (semaphoreOf(pid, id) == NULL) {
+        return -1;
+    }
+
+    registryClose(&registry, pid, id);
+    return 0;
+}
+
+void semaphoreRelease(int pid) {
+    if (!isValidPid(pid)) {
+        return;
+    }
+
+    Process * process = &processTable[pid - 1];
+    uint32_t self = 1u << (pid - 1);
+
+    // Wait state belongs to the thread, the semaphore may be one its process opened (and may have closed already)
+    for (int32_t id = 0; id < REGISTRY_MAX_OBJECTS; id++) {
+        Semaphore * semaphore = &semaphores[id];
+        if (!registryExists(&registry, id)) {
+            continue;
+        }
+
+        if (semaphore->granted & self) {
+            // Woken but killed before taking the unit: the next waiter gets it
+            semaphore->granted &= ~self;
+            handOff(semaphore);
+        } else if (process->blockedOn == &semaphore->queue) {
+            // Killed while asleep: undo its decrement
+            waitQueueRemove(&semaphore->queue, pid);
+            process->blockedOn = NULL;
+            __atomic_fetch_add(&counters[id], 1, __ATOMIC_SEQ_CST);
+        }
+    }
+
+    for (int32_t id = registryNextOpened(&registry, pid, 0); id >= 0; id = registryNextOpened(&registry, pid, id + 1)) {
+        semaphoreClose(pid, id);
+    }
+}
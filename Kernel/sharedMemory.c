@@ -0,0 +1,78 @@
+#include <sharedMemory.h>
+#include <stddef.h>
+#include <lib.h>
+#include <MemoryManager.h>
+#include <process.h>
+#include <registry.h>
+
+typedef struct {
+    void * address;
+    uint64_t size;
+} Segment;
+
+static Registry registry; // opened means attached
+static Segment segments[REGISTRY_MAX_OBJECTS];
+
+static int32_t create(const char * name, uint64_t size) {
+    void * address = allocMemory(size);
+    if (address == NULL) {
+        return -1;
+    }
+
+    int32_t id = registryCreate(&registry, name);
+    if (id < 0) {
+        freeMemory(address);
+        return -1;
+    }
+
+    memset(address, 0, size);
+    segments[id].address = address;
+    segments[id].size = size;
+    return id;
+}
+
+int32_t sharedMemoryOpen(int pid, const char * name, uint64_t size, void ** address) {
+    if (!isValidPid(pid) || address == NULL || (name != NULL && name[0] == 0)) {
+        return -1;
+    }
+
+    int32_t id = registryFind(&registry, name);
+    if (id < 0) {
+        if (size == 0) {
+            return -1;
+        }
+        id = create(name, size);
+    }
+
+    if (id < 0 || sharedMemoryAttach(pid, id, address) < 0) {
+        return -1;
+    }
+    return id;
+}
+
+int32_t sharedMemoryAttach(int pid, int32_t id, void ** address) {
+    if (address == NULL || !registryAttach(&registry, pid, id)) {
+        return -1;
+    }
+
+    *address = segments[id].address;
+    return (int32_t) segments[id].size;
+}
+
+int32_t sharedMemoryDetach(int pid, int32_t id) {
+    if (!registryIsOpen(&registry, pid, id)) {
+        return -1;
+    }
+
+    if (registryClose(&registry, pid, id)) {
+        freeMemory(segments[id].address);
+        segments[id].address = NULL;
+    }
+    return 0;
+}
+
+void sharedMemoryRelease(int pid) {
+    for (int32_t id = registryNextOpened(&registry, pid, 0); id >= 0; id = registryNextOpened(&registry, pid, id + 1)) {
+        sharedMemoryDetach(pid, id);
+    }
+}
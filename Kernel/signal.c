@@ -0,0 +1,193 @@
+#include <signal.h>
+#include <stddef.h>
+#include <deferredWork.h>
+
+#define SIGNAL_STACK_MARGIN 1024 // left below the handler frame for the handler itself
+
+extern uint8_t endOfKernelBinary;
+extern void (*signalTrampoline)(void); // only its address is used, see `signalDeliver`
+
+static int foregroundGroup = 0; // 0 while nobody is in the foreground
+
+static uint8_t validSignal(int signal) {
+    return signal > 0 && signal < SIGNAL_COUNT;
+}
+
+static Process * liveProcess(int pid) {
+    if (pid <= 0 || pid > MAX_PROCESSES) {
+        return NULL;
+    }
+    Process * process = &processTable[pid - 1];
+    if (process->pid != pid || process->state == ZOMBIE || process->state == TERMINATED) {
+        return NULL;
+    }
+    return process;
+}
+
+static void terminate(Process * process, int signal) {
+    killProcessWithExitCode(process->pid, SIGNAL_EXIT_CODE(signal));
+
+    // It signalled itself from a system call: it does not go back to its code
+    // Deferred work runs on the interrupted process' stack, that one is switched away on the next tick
+    if (process == getCurrentProcess() && !deferredWorkIsRunning()) {
+        exitCurrentProcess(SIGNAL_EXIT_CODE(signal));
+    }
+}
+
+// Takes the actions that do not need the process to run: ignoring and terminating
+static void settle(Process * process) {
+    uint32_t ready = process->pendingSignals & ~process->blockedSignals;
+
+    for (int signal = 1; ready != 0 && signal < SIGNAL_COUNT; signal++) {
+        if (!(ready & SIGNAL_MASK(signal))) {
+            continue;
+        }
+        ready &= ~SIGNAL_MASK(signal);
+
+        SignalHandler handler = process->signalHandlers[signal];
+        if (handler == SIG_IGN) {
+            process->pendingSignals &= ~SIGNAL_MASK(signal);
+        } else if (handler == SIG_DFL) {
+            process->pendingSignals &= ~SIGNAL_MASK(signal);
+            terminate(process, signal);
+            return;
+        }
+    }
+}
+
+static void post(Process * process, int signal) {
+    if (signal == SIGKILL) {
+        terminate(process, signal);
+        return;
+    }
+    if (process->signalHandlers[signal] == SIG_IGN) {
+        return;
+    }
+
+    process->pendingSignals |= SIGNAL_MASK(signal);
+    settle(process);
+}
+
+int32_t signalSend(int pid, int signal) {
+    if (!validSignal(signal)) {
+        return -1;
+    }
+
+    if (pid > 0) {
+        Process * process = liveProcess(pid);
+        if (process == NULL) {
+            return -1;
+        }
+        post(process, signal);
+        return 0;
+    }
+
+    // The sender goes last, terminating it may not return
+    Process * self = NULL;
+    int32_t result = -1;
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        Process * process = liveProcess(i + 1);
+        if (process == NULL || process->processGroup != -pid) {
+            continue;
+        }
+
+        result = 0;
+        if (process == getCurrentProcess()) {
+            self = process;
+        } else {
+            post(process, signal);
+        }
+    }
+
+    if (self != NULL) {
+        post(self, signal);
+    }
+    return result;
+}
+
+void signalInterruptForeground(void) {
+    if (foregroundGroup > 0) {
+        signalSend(-foregroundGroup, SIGINT);
+    }
+}
+
+void signalSetForegroundGroup(int group) {
+    foregroundGroup = group > 0 ? group : 0;
+}
+
+int32_t signalSetHandler(int pid, int signal, SignalHandler handler, SignalHandler * previous) {
+    Process * process = liveProcess(pid);
+    if (process == NULL || !validSignal(signal) || signal == SIGKILL) {
+        return -1;
+    }
+
+    if (previous != NULL) {
+        *previous = process->signalHandlers[signal];
+    }
+    process->signalHandlers[signal] = handler;
+    settle(process);
+    return 0;
+}
+
+int32_t signalSetMask(int pid, uint32_t mask, uint32_t * previous) {
+    Process * process = liveProcess(pid);
+    if (process == NULL) {
+        return -1;
+    }
+
+    if (previous != NULL) {
+        *previous = process->blockedSignals;
+    }
+    process->blockedSignals = mask & ~SIGNAL_MASK(SIGKILL);
+    settle(process);
+    return 0;
+}
+
+uint64_t signalDeliver(Process * process) {
+    uint32_t ready = process->pendingSignals & ~process->blockedSignals;
+    StackFrame * frame = (StackFrame *) process->ctx;
+
+    // Inside a system call, deferred work or the trampoline: it waits until the process is back in its own code
+    if (ready == 0 || frame->rip < (uint64_t) &endOfKernelBinary) {
+        return process->ctx;
+    }
+
+    int signal = __builtin_ctz(ready);
+    SignalHandler handler = process->signalHandlers[signal];
+    if (handler == SIG_DFL || handler == SIG_IGN) {
+        process->pendingSignals &= ~SIGNAL_MASK(signal); // settled when it was posted
+        return process->ctx;
+    }
+
+    // The interrupted state is copied below the current frame, the new frame enters the trampoline on top of it
+    uint64_t top = (process->ctx - sizeof(SignalFrame)) & ~(uint64_t) 0xF;
+    if (top - sizeof(StackFrame) < (uint64_t) process->stackBase + SIGNAL_STACK_MARGIN) {
+        return process->ctx; // stays pending until the stack unwinds
+    }
+
+    SignalFrame * saved = (SignalFrame *) top;
+    saved->blockedSignals = process->blockedSignals;
+    saved->interrupted = *frame;
+
+    StackFrame * entry = (StackFrame *) (top - sizeof(StackFrame));
+    *entry = *frame;
+    entry->rip = (uint64_t) &signalTrampoline;
+    entry->rsp = top;
+    entry->rdi = (uint64_t) signal;
+    entry->rsi = (uint64_t) handler;
+
+    process->pendingSignals &= ~SIGNAL_MASK(signal);
+    process->blockedSignals |= SIGNAL_MASK(signal); // handlers are not reentered
+    process->ctx = (uint64_t) entry;
+    return process->ctx;
+}
+
+void signalReturn(SignalFrame * frame) {
+    Process * process = getCurrentProcess();
+    if (process == NULL) {
+        return;
+    }
+
+    process->blockedSignals = (uint32_t) frame->blockedSignals & ~SIGNAL_MASK(SIGKILL);
+    settle(process); // what was posted while the handler ran
+}
@@ -0,0 +1,58 @@
+#include <trace.h>
+#include <process.h>
+#include <lib.h>
+
+#define BARRIER() __asm__ volatile ("" ::: "memory")
+#define TRACE_MASK (TRACE_BUFFER_ENTRIES - 1)
+
+volatile uint8_t traceEnabled = 0;
+
+static TraceEvent events[TRACE_BUFFER_ENTRIES];
+static volatile uint64_t head = 0; // number of events ever reserved
+
+void traceRecord(uint16_t type, uint64_t arg0, uint64_t arg1) {
+    uint64_t number = __atomic_fetch_add(&head, 1, __ATOMIC_RELAXED);
+    TraceEvent * event = &events[number & TRACE_MASK];
+
+    event->sequence = 0;
+    BARRIER(); // a reader must not take the old contents for the new event
+    event->tsc = readTSC();
+    event->type = type;
+    event->pid = (int16_t) currentPid;
+    event->arg0 = arg0;
+    event->arg1 = arg1;
+    BARRIER();
+    event->sequence = (uint32_t) number + 1;
+}
+
+uint8_t traceSetEnabled(uint8_t enabled) {
+    uint8_t previous = traceEnabled;
+    traceEnabled = enabled != 0;
+    return previous;
+}
+
+uint32_t traceRead(TraceEvent * buffer, uint32_t capacity, uint64_t * cursor) {
+    uint64_t end = head;
+    uint64_t number = *cursor;
+    if (end - number > TRACE_BUFFER_ENTRIES) { // also a cursor past the end
+        number = end > TRACE_BUFFER_ENTRIES ? end - TRACE_BUFFER_ENTRIES : 0;
+    }
+
+    uint32_t count = 0;
+    for (; number < end && count < capacity; number++) {
+        const TraceEvent * event = &events[number & TRACE_MASK];
+        uint32_t sequence = (uint32_t) number + 1;
+        if (event->sequence != sequence) {
+            continue; // still being written, or already overwritten
+        }
+
+        buffer[count] = *event;
+        BARRIER();
+        if (event->sequence == sequence) {
+            count++;
+        }
+    }
+
+    *cursor = number;
+    return count;
+}
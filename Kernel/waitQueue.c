@@ -0,0 +1,110 @@
+#include <waitQueue.h>
+#include <stddef.h>
+#include <process.h>
+#include <scheduler.h>
+#include <interrupts.h>
+#include <trace.h>
+
+void waitQueueInit(WaitQueue * queue) {
+    queue->head = 0;
+    queue->count = 0;
+}
+
+static void push(WaitQueue * queue, int pid) {
+    queue->pids[(queue->head + queue->count) % PROCESS_MAX_COUNT] = pid;
+    queue->count++;
+}
+
+static int pop(WaitQueue * queue) {
+    int pid = queue->pids[queue->head];
+    queue->head = (queue->head + 1) % PROCESS_MAX_COUNT;
+    queue->count--;
+    return pid;
+}
+
+void waitQueueRemove(WaitQueue * queue, int pid) {
+    if (queue == NULL) {
+        return;
+    }
+
+    uint8_t count = queue->count;
+    for (uint8_t i = 0; i < count; i++) {
+        int queued = pop(queue);
+        if (queued != pid) {
+            push(queue, queued);
+        }
+    }
+}
+
+void waitQueueSleep(WaitQueue * queue) {
+    Process * process = getCurrentProcess();
+    if (process == NULL) {
+        return;
+    }
+
+    push(queue, process->pid);
+    process->blockedOn = queue;
+    process->state = BLOCKED;
+    TRACE(TRACE_BLOCK, process->pid, queue);
+
+    _yield(); // switches away now, a wakeup makes the process READY again
+    _cli();
+
+    // Woken by something else than the queue
+    if (process->blockedOn == queue) {
+        waitQueueRemove(queue, process->pid);
+        process->blockedOn = NULL;
+        if (process->state == BLOCKED) {
+            process->state = RUNNING;
+        }
+    }
+}
+
+static uint8_t wake(WaitQueue * queue, int pid) {
+    if (pid <= 0 || pid > MAX_PROCESSES) {
+        return 0;
+    }
+
+    Process * process = &processTable[pid - 1];
+    if (process->pid != pid || process->blockedOn != queue) {
+        return 0;
+    }
+
+    process->blockedOn = NULL;
+    if (process->state != BLOCKED) {
+        return 1;
+    }
+
+    // It may not have switched away yet (woken before its `_yield`)
+    if (process == getCurrentProcess()) {
+        process->state = RUNNING;
+    } else {
+        process->state = READY;
+        schedulerAddProcess(process);
+    }
+    TRACE(TRACE_UNBLOCK, pid, queue);
+    return 1;
+}
+
+int waitQueueWakeOne(WaitQueue * queue) {
+    while (queue->count > 0) {
+        int pid = pop(queue);
+        if (wake(queue, pid)) {
+            return pid;
+        }
+    }
+    return 0;
+}
+
+uint8_t waitQueueWakeAll(WaitQueue * queue) {
+    uint8_t woken = 0;
+    while (queue->count > 0) {
+        woken += wake(queue, pop(queue));
+    }
+    return woken;
+}
+
+uint8_t waitQueueWake(WaitQueue * queue, int pid) {
+    waitQueueRemove(queue, pid);
+    return wake(queue, pid);
+}
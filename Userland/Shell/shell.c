@@ -5,6 +5,7 @@
 #include <stdint.h>
 
 #include <sys.h>
+#include <asyncIo.h>
 #include <exceptions.h>
 
 #ifdef ANSI_4_BIT_COLOR_SUPPORT
@@ -12,6 +13,11 @@
 #endif
 
 #define MAX_BUFFER_SIZE 1024
+#define MAX_COMMAND_ARGS 32
+#define COMMAND_PRIORITY PROCESS_PRIORITY_MIN
+#define MAX_BACKGROUND_COMMANDS 16
+#define MAX_PIPELINE_STAGES 8
+#define PIPE_CHUNK_SIZE 1024
 #define HISTORY_SIZE 10
 #define PROCESS_SNAPSHOT_CAP 32
 #define PID_COL_WIDTH 3
@@ -21,7 +27,19 @@
 #define NAME_COL_WIDTH 8
 #define STACK_COL_WIDTH 10
 #define BASE_COL_WIDTH 10
+#define SYSCALL_NAME_COL_WIDTH 34
+#define IRQ_NAME_COL_WIDTH 14
 #define COLUMN_PADDING 2
+#define SYSCALL_BENCH_ITERATIONS 100000
+#define SYSCALL_STATS_CAP 64
+#define IO_RING_BENCH_BATCHES 1000
+#define PROFILE_MAX_SECONDS 60
+#define PROFILE_MAX_SYMBOLS 4096
+#define PROFILE_MAX_ENTRIES 512
+#define PROFILE_TOP_FUNCTIONS 5
+#define TRACE_SHOWN_DEFAULT 32
+#define TRACE_SHOWN_MAX 256
+#define TRACE_READ_CHUNK 64
 
 #define INC_MOD(x, m) x = (((x) + 1) % (m))
 #define SUB_MOD(a, b, m) ((a) - (b) < 0 ? (m) - (b) + (a) : (a) - (b))
@@ -30,22 +48,31 @@
 static char buffer[MAX_BUFFER_SIZE];
 static int buffer_dim = 0;
 
-int clear(void);
-int echo(void);
-int exit(void);
-int fontdec(void);
-int font(void);
-int help(void);
-int history(void);
-int block(void);
-int man(void);
-int memcmd(void);
-int killcmd(void);
-int regs(void);
-int time(void);
-int ps(void);
-int nice(void);
-int test_mm_command(void);
+int cat(int argc, char *argv[]);
+int clear(int argc, char *argv[]);
+int echo(int argc, char *argv[]);
+int exit(int argc, char *argv[]);
+int fontdec(int argc, char *argv[]);
+int font(int argc, char *argv[]);
+int help(int argc, char *argv[]);
+int history(int argc, char *argv[]);
+int ioringbench(int argc, char *argv[]);
+int irqstat(int argc, char *argv[]);
+int block(int argc, char *argv[]);
+int man(int argc, char *argv[]);
+int memcmd(int argc, char *argv[]);
+int killcmd(int argc, char *argv[]);
+int regs(int argc, char *argv[]);
+int syscallbench(int argc, char *argv[]);
+int syscalls(int argc, char *argv[]);
+int time(int argc, char *argv[]);
+int trace(int argc, char *argv[]);
+int ps(int argc, char *argv[]);
+int nice(int argc, char *argv[]);
+int profile(int argc, char *argv[]);
+int test_mm_command(int argc, char *argv[]);
+int test_sync_command(int argc, char *argv[]);
+int wc(int argc, char *argv[]);
 
 static void printPreviousCommand(enum REGISTERABLE_KEYS scancode);
 static void printNextCommand(enum REGISTERABLE_KEYS scancode);
@@ -54,39 +81,56 @@ static int digitsForInt(int value);
 static void printIntColumn(int value, int width);
 static void printStringColumn(const char *value, int width);
 static int parsePid(const char *arg, int *pidOut);
+static int loadSymbols(void);
+static int findSymbol(uint64_t address);
 static void handleCtrlC(enum REGISTERABLE_KEYS scancode);
-uint8_t ctrlCIsPending(void);
-static void consumeCtrlC(void);
+static int commandMain(int argc, char *argv[]);
+static int runPipeline(int stageCount, int stageArgc[], char **stages[], uint8_t background);
+static void reapBackgroundCommands(void);
 
 static uint8_t last_command_arrowed = 0;
-static volatile uint8_t ctrl_c_requested = 0;
+static int32_t background_pids[MAX_BACKGROUND_COMMANDS] = {0};
+
+// Commands run in their own process, argv[0] is the command name
+typedef int (*CommandFunction)(int argc, char *argv[]);
 
 typedef struct
 {
     char *name;
-    int (*function)(void);
+    CommandFunction function;
     char *description;
 } Command;
 
+static const Command *findCommand(char *name);
+
 /* All available commands. Sorted alphabetically by their name */
 Command commands[] = {
-    {.name = "block", .function = (int (*)(void))(unsigned long long)block, .description = "Toggles a process between BLOCKED and READY"},
-    {.name = "clear", .function = (int (*)(void))(unsigned long long)clear, .description = "Clears the screen"},
-    {.name = "divzero", .function = (int (*)(void))(unsigned long long)_divzero, .description = "Generates a division by zero exception"},
-    {.name = "echo", .function = (int (*)(void))(unsigned long long)echo, .description = "Prints the input string"},
-    {.name = "exit", .function = (int (*)(void))(unsigned long long)exit, .description = "Command exits w/ the provided exit code or 0"},
-    {.name = "font", .function = (int (*)(void))(unsigned long long)font, .description = "Increases or decreases the font size.\n\t\t\t\tUse:\n\t\t\t\t\t  + font increase\n\t\t\t\t\t  + font decrease"},
-    {.name = "help", .function = (int (*)(void))(unsigned long long)help, .description = "Prints the available commands"},
-    {.name = "history", .function = (int (*)(void))(unsigned long long)history, .description = "Prints the command history"},
-    {.name = "invop", .function = (int (*)(void))(unsigned long long)_invalidopcode, .description = "Generates an invalid Opcode exception"},
-    {.name = "kill", .function = (int (*)(void))(unsigned long long)killcmd, .description = "Kills a process by PID"},
-    {.name = "man", .function = (int (*)(void))(unsigned long long)man, .description = "Prints the description of the provided command"},
-    {.name = "mem", .function = (int (*)(void))(unsigned long long)memcmd, .description = "Displays kernel memory usage"},
-    {.name = "nice", .function = (int (*)(void))(unsigned long long)nice, .description = "Changes a process priority"},
-    {.name = "ps", .function = (int (*)(void))(unsigned long long)ps, .description = "Prints the process list"},
-    {.name = "regs", .function = (int (*)(void))(unsigned long long)regs, .description = "Prints the register snapshot, if any"},
-    {.name = "test_mm", .function = (int (*)(void))(unsigned long long)test_mm_command, .description = "Stress tests memory manager with random blocks. Usage: test_mm <max_bytes>"},
-    {.name = "time", .function = (int (*)(void))(unsigned long long)time, .description = "Prints the current time"},
+    {.name = "block", .function = (CommandFunction)(unsigned long long)block, .description = "Toggles a process between BLOCKED and READY"},
+    {.name = "cat", .function = (CommandFunction)(unsigned long long)cat, .description = "Copies its input to its output until end of file. Usage: <command> | cat"},
+    {.name = "clear", .function = (CommandFunction)(unsigned long long)clear, .description = "Clears the screen"},
+    {.name = "divzero", .function = (CommandFunction)(unsigned long long)_divzero, .description = "Generates a division by zero exception"},
+    {.name = "echo", .function = (CommandFunction)(unsigned long long)echo, .description = "Prints the input string"},
+    {.name = "exit", .function = (CommandFunction)(unsigned long long)exit, .description = "Command exits w/ the provided exit code or 0"},
+    {.name = "font", .function = (CommandFunction)(unsigned long long)font, .description = "Increases or decreases the font size.\n\t\t\t\tUse:\n\t\t\t\t\t  + font increase\n\t\t\t\t\t  + font decrease"},
+    {.name = "help", .function = (CommandFunction)(unsigned long long)help, .description = "Prints the available commands"},
+    {.name = "history", .function = (CommandFunction)(unsigned long long)history, .description = "Prints the command history"},
+    {.name = "ioringbench", .function = (CommandFunction)(unsigned long long)ioringbench, .description = "Measures the cycles per operation of batched submissions through the submission ring"},
+    {.name = "invop", .function = (CommandFunction)(unsigned long long)_invalidopcode, .description = "Generates an invalid Opcode exception"},
+    {.name = "irqstat", .function = (CommandFunction)(unsigned long long)irqstat, .description = "Prints interrupt handler and masked section latencies: max, average and histogram (log2 of TSC cycles)"},
+    {.name = "kill", .function = (CommandFunction)(unsigned long long)killcmd, .description = "Kills a process by PID"},
+    {.name = "man", .function = (CommandFunction)(unsigned long long)man, .description = "Prints the description of the provided command"},
+    {.name = "mem", .function = (CommandFunction)(unsigned long long)memcmd, .description = "Displays kernel memory usage"},
+    {.name = "nice", .function = (CommandFunction)(unsigned long long)nice, .description = "Changes a process priority"},
+    {.name = "profile", .function = (CommandFunction)(unsigned long long)profile, .description = "Samples the running code for the given seconds and prints the top functions per process. Usage: profile <seconds>"},
+    {.name = "ps", .function = (CommandFunction)(unsigned long long)ps, .description = "Prints the process list"},
+    {.name = "regs", .function = (CommandFunction)(unsigned long long)regs, .description = "Prints the register snapshot, if any"},
+    {.name = "syscallbench", .function = (CommandFunction)(unsigned long long)syscallbench, .description = "Measures the cycles of an empty system call, through int 80h and through SYSCALL"},
+    {.name = "syscalls", .function = (CommandFunction)(unsigned long long)syscalls, .description = "Prints how many times each system call ran and its latency histogram (log2 of TSC cycles)"},
+    {.name = "test_mm", .function = (CommandFunction)(unsigned long long)test_mm_command, .description = "Stress tests memory manager with random blocks. Usage: test_mm <max_bytes>"},
+    {.name = "test_sync", .function = (CommandFunction)(unsigned long long)test_sync_command, .description = "Two pairs of processes add and subtract 1 to a shared value n times each, it ends at 0 if they use a semaphore. Usage: test_sync <n> <use_sem>"},
+    {.name = "time", .function = (CommandFunction)(unsigned long long)time, .description = "Prints the current time"},
+    {.name = "trace", .function = (CommandFunction)(unsigned long long)trace, .description = "Prints the last kernel trace events as a timeline (TSC cycles), or turns tracing on (off at boot) and off. Usage: trace [on | off | <events>]"},
+    {.name = "wc", .function = (CommandFunction)(unsigned long long)wc, .description = "Counts the lines, words and characters of its input. Usage: <command> | wc"},
 };
 
 char command_history[HISTORY_SIZE][MAX_BUFFER_SIZE] = {0};
@@ -96,10 +140,16 @@ uint8_t command_history_last = 0;
 static uint64_t last_command_output = 0;
 
 extern uint64_t test_mm(uint64_t argc, char *argv[]);
+extern uint64_t test_sync(uint64_t argc, char *argv[]);
 
 int main()
 {
-    clear();
+    clear(0, NULL);
+
+    // Commands get their own process group, Ctrl+C only reaches the shell while it is at the prompt
+    setProcessGroup(0, 0);
+    setForegroundGroup(getPid());
+    setSignalHandler(SIGINT, SIG_IGN);
 
     registerKey(KP_UP_KEY, printPreviousCommand);
     registerKey(KP_DOWN_KEY, printNextCommand);
@@ -120,11 +170,6 @@ int main()
         buffer[buffer_dim] = 0;
         command_history_buffer[buffer_dim] = 0;
 
-        if (ctrlCIsPending() && buffer_dim == 0)
-        {
-            consumeCtrlC();
-        }
-
         if (buffer_dim == MAX_BUFFER_SIZE)
         {
             perror("\e[0;31mShell buffer overflow\e[0m\n");
@@ -136,33 +181,87 @@ int main()
 
         buffer[buffer_dim] = 0;
 
-        char *command = strtok(buffer, " ");
-        int i = 0;
+        reapBackgroundCommands();
 
-        for (; i < sizeof(commands) / sizeof(Command); i++)
+        char *args[MAX_COMMAND_ARGS + 1];
+        int argc = 0;
+        for (char *token = strtok(buffer, " "); token != NULL && argc < MAX_COMMAND_ARGS; token = strtok(NULL, " "))
         {
-            if (strcmp(commands[i].name, command) == 0)
+            args[argc++] = token;
+        }
+
+        // A trailing `&`, alone or stuck to the last argument, runs the command in the background
+        uint8_t background = 0;
+        if (argc > 0)
+        {
+            char *last = args[argc - 1];
+            int length = strlen(last);
+            if (last[length - 1] == '&')
             {
-                last_command_output = commands[i].function();
-                strncpy(command_history[command_history_last], command_history_buffer, 255);
-                command_history[command_history_last][buffer_dim] = '\0';
-                INC_MOD(command_history_last, HISTORY_SIZE);
-                last_command_arrowed = command_history_last;
-                break;
+                background = 1;
+                last[length - 1] = 0;
+                if (length == 1)
+                {
+                    argc--;
+                }
             }
         }
-
-        // If the command is not found, ignore \n
-        if (i == sizeof(commands) / sizeof(Command))
+        args[argc] = NULL;
+
+        // `a | b`: every `|` token ends a stage, the stage's argv ends there too
+        char **stages[MAX_PIPELINE_STAGES];
+        int stageArgc[MAX_PIPELINE_STAGES];
+        int stageCount = 0;
+        uint8_t validPipeline = 1;
+        for (int start = 0; argc > 0 && start <= argc && validPipeline;)
         {
-            if (command != NULL && *command != '\0')
+            int end = start;
+            while (end < argc && strcmp(args[end], "|") != 0)
             {
-                fprintf(FD_STDERR, "\e[0;33mCommand not found:\e[0m %s\n", command);
+                end++;
             }
-            else if (command == NULL)
+
+            if (end == start || stageCount == MAX_PIPELINE_STAGES)
             {
-                printf("\n");
+                validPipeline = 0;
+                break;
             }
+            stages[stageCount] = &args[start];
+            stageArgc[stageCount++] = end - start;
+            args[end] = NULL;
+            start = end + 1;
+        }
+
+        char *command = argc > 0 ? args[0] : NULL;
+        char *missing = NULL;
+        for (int i = 0; i < stageCount && missing == NULL; i++)
+        {
+            if (findCommand(stages[i][0]) == NULL)
+            {
+                missing = stages[i][0];
+            }
+        }
+
+        if (command != NULL && !validPipeline)
+        {
+            fprintf(FD_STDERR, "\e[0;33mInvalid pipeline\e[0m\n");
+        }
+        else if (command != NULL && missing == NULL)
+        {
+            last_command_output = runPipeline(stageCount, stageArgc, stages, background);
+            strncpy(command_history[command_history_last], command_history_buffer, 255);
+            command_history[command_history_last][buffer_dim] = '\0';
+            INC_MOD(command_history_last, HISTORY_SIZE);
+            last_command_arrowed = command_history_last;
+        }
+        // If the command is not found, ignore \n
+        else if (command != NULL && *missing != '\0')
+        {
+            fprintf(FD_STDERR, "\e[0;33mCommand not found:\e[0m %s\n", missing);
+        }
+        else if (command == NULL)
+        {
+            printf("\n");
         }
 
         buffer[0] = buffer_dim = 0;
@@ -192,29 +291,170 @@ static void printNextCommand(enum REGISTERABLE_KEYS scancode)
     }
 }
 
+// The kernel sends SIGINT to the foreground group, this only resets the input line
 static void handleCtrlC(enum REGISTERABLE_KEYS scancode)
 {
     (void)scancode;
     clearInputBuffer();
     fprintf(FD_STDOUT, "^C");
+    fflush(FD_STDOUT); // key handlers run on whatever process was interrupted, do not leave it in its buffer
     fprintf(FD_STDIN, "\n");
     buffer_dim = 0;
     buffer[0] = 0;
     command_history_buffer[0] = 0;
-    ctrl_c_requested = 1;
 }
 
-uint8_t ctrlCIsPending(void)
+static const Command *findCommand(char *name)
+{
+    for (int i = 0; i < sizeof(commands) / sizeof(Command); i++)
+    {
+        if (strcmp(commands[i].name, name) == 0)
+        {
+            return &commands[i];
+        }
+    }
+    return NULL;
+}
+
+// Entry point of every command process. Output is buffered per pid: start clean, flush it before exiting
+static int commandMain(int argc, char *argv[])
 {
-    return ctrl_c_requested;
+    resetStreams();
+    const Command *command = findCommand(argv[0]);
+    int result = command == NULL ? 1 : command->function(argc, argv);
+    fflush(-1);
+    return result;
+}
+
+static void trackBackgroundCommand(int32_t pid)
+{
+    for (int i = 0; i < MAX_BACKGROUND_COMMANDS; i++)
+    {
+        if (background_pids[i] == 0)
+        {
+            background_pids[i] = pid;
+            return;
+        }
+    }
+}
+
+// Starts one process per stage, each stage's stdout is a pipe into the next one's stdin
+// Children inherit descriptors 0 to 2, so the shell points its own at the pipe ends while it creates them
+// Foreground pipelines are waited for and return the exit code of the last stage, background ones return 0 right away
+// Each pipeline is a process group led by its first stage, the foreground one gets Ctrl+C
+static int runPipeline(int stageCount, int stageArgc[], char **stages[], uint8_t background)
+{
+    int32_t pids[MAX_PIPELINE_STAGES];
+    int32_t savedStdin = dupFd(FD_STDIN);
+    int32_t savedStdout = dupFd(FD_STDOUT);
+    int32_t readEnd = -1;
+    int started = 0;
+
+    fflush(FD_STDOUT);
+
+    for (; started < stageCount; started++)
+    {
+        int32_t fds[2] = {-1, -1};
+        if (started < stageCount - 1 && createPipe(fds) < 0)
+        {
+            break;
+        }
+
+        if (readEnd >= 0)
+        {
+            dup2Fd(readEnd, FD_STDIN);
+        }
+        if (fds[1] >= 0)
+        {
+            dup2Fd(fds[1], FD_STDOUT);
+        }
+
+        pids[started] = createProcess(commandMain, stageArgc[started], stages[started], COMMAND_PRIORITY, !background);
+
+        dup2Fd(savedStdin, FD_STDIN);
+        dup2Fd(savedStdout, FD_STDOUT);
+        if (readEnd >= 0)
+        {
+            closeFd(readEnd);
+        }
+        if (fds[1] >= 0)
+        {
+            closeFd(fds[1]);
+        }
+        readEnd = fds[0];
+
+        if (pids[started] <= 0)
+        {
+            break;
+        }
+        setProcessGroup(pids[started], pids[0]);
+    }
+
+    if (readEnd >= 0)
+    {
+        closeFd(readEnd);
+    }
+    closeFd(savedStdin);
+    closeFd(savedStdout);
+
+    // The stages already running see end of file on their stdin and finish on their own
+    if (started < stageCount)
+    {
+        fprintf(FD_STDERR, "\e[0;31mCould not start:\e[0m %s\n", stages[started][0]);
+    }
+
+    if (background)
+    {
+        for (int i = 0; i < started; i++)
+        {
+            trackBackgroundCommand(pids[i]);
+            printf("[%d]%s", pids[i], i == started - 1 ? "\n" : " ");
+        }
+        return started < stageCount;
+    }
+
+    if (started > 0)
+    {
+        setForegroundGroup(pids[0]);
+    }
+
+    int32_t exitCode = 0;
+    for (int i = 0; i < started; i++)
+    {
+        if (waitPid(pids[i], &exitCode, 0) < 0)
+        {
+            exitCode = 1;
+        }
+    }
+
+    setForegroundGroup(getPid());
+    return started < stageCount ? 1 : exitCode;
 }
 
-static void consumeCtrlC(void)
+// Reports and releases the background commands that finished since the last prompt
+static void reapBackgroundCommands(void)
 {
-    ctrl_c_requested = 0;
+    for (int i = 0; i < MAX_BACKGROUND_COMMANDS; i++)
+    {
+        if (background_pids[i] == 0)
+        {
+            continue;
+        }
+
+        int32_t exitCode = 0;
+        int32_t result = waitPid(background_pids[i], &exitCode, WAIT_NO_HANG);
+        if (result > 0)
+        {
+            printf("[%d] done (%d)\n", background_pids[i], exitCode);
+        }
+        if (result != 0)
+        {
+            background_pids[i] = 0;
+        }
+    }
 }
 
-int history(void)
+int history(int argc, char *argv[])
 {
     uint8_t last = command_history_last;
     DEC_MOD(last, HISTORY_SIZE);
@@ -228,7 +468,7 @@ int history(void)
     return 0;
 }
 
-int time(void)
+int time(int argc, char *argv[])
 {
     int hour, minute, second;
     getDate(&hour, &minute, &second);
@@ -236,29 +476,39 @@ int time(void)
     return 0;
 }
 
-int test_mm_command(void)
+int test_sync_command(int argc, char *argv[])
 {
-    char *arg = strtok(NULL, " ");
+    if (argc != 3)
+    {
+        fprintf(FD_STDERR, "Usage: test_sync <n> <use_sem>\n");
+        return 1;
+    }
+    return (int)test_sync(2, &argv[1]);
+}
 
-    if (arg == NULL)
+int test_mm_command(int argc, char *argv[])
+{
+    if (argc < 2)
     {
         fprintf(FD_STDERR, "Usage: test_mm <max_memory_bytes>\n");
         return 1;
     }
 
-    if (strtok(NULL, " ") != NULL)
+    if (argc > 2)
     {
         fprintf(FD_STDERR, "test_mm accepts exactly one parameter\n");
         return 1;
     }
 
-    char *argv[] = {arg};
+    char *arg = argv[1];
+    char *testArgv[] = {arg};
 
     printf("test_mm running with max %s bytes. Press CTRL+C to stop.\n", arg);
 
-    while (!ctrlCIsPending())
+    // Ctrl+C terminates the process (SIGINT), nothing to poll
+    while (1)
     {
-        uint64_t result = test_mm(1, argv);
+        uint64_t result = test_mm(1, testArgv);
         if (result != 0)
         {
             long long signed_result = (long long)result;
@@ -266,62 +516,106 @@ int test_mm_command(void)
             return (int)signed_result;
         }
     }
+}
 
-    consumeCtrlC();
-    return 130;
+int cat(int argc, char *argv[])
+{
+    char chunk[PIPE_CHUNK_SIZE];
+    int32_t count;
+    while ((count = readFd(FD_STDIN, chunk, PIPE_CHUNK_SIZE)) > 0)
+    {
+        if (writeFd(FD_STDOUT, chunk, count) < 0)
+        {
+            return 1;
+        }
+    }
+    return count < 0;
 }
 
-int echo(void)
+int wc(int argc, char *argv[])
 {
-    for (int i = strlen("echo") + 1; i < buffer_dim; i++)
+    char chunk[PIPE_CHUNK_SIZE];
+    uint64_t lines = 0, words = 0, characters = 0;
+    uint8_t inWord = 0;
+    int32_t count;
+    while ((count = readFd(FD_STDIN, chunk, PIPE_CHUNK_SIZE)) > 0)
     {
-        switch (buffer[i])
+        for (int i = 0; i < count; i++)
+        {
+            char c = chunk[i];
+            uint8_t space = c == ' ' || c == '\n' || c == '\t';
+            lines += c == '\n';
+            words += inWord && space;
+            inWord = !space;
+        }
+        characters += count;
+    }
+    words += inWord;
+
+    printf("%d %d %d\n", (int)lines, (int)words, (int)characters);
+    return count < 0;
+}
+
+int echo(int argc, char *argv[])
+{
+    for (int arg = 1; arg < argc; arg++)
+    {
+        char *text = argv[arg];
+        if (arg > 1)
+        {
+            putchar(' ');
+        }
+
+        for (int i = 0; text[i] != 0; i++)
         {
-        case '\\':
-            switch (buffer[i + 1])
+            switch (text[i])
             {
-            case 'n':
-                printf("\n");
-                i++;
-                break;
-            case 'e':
+            case '\\':
+                switch (text[i + 1])
+                {
+                case 'n':
+                    printf("\n");
+                    i++;
+                    break;
+                case 'e':
 #ifdef ANSI_4_BIT_COLOR_SUPPORT
-                i++;
-                parseANSI(buffer, &i);
+                    i++;
+                    parseANSI(text, &i);
 #else
-                while (buffer[i] != 'm')
-                    i++; // ignores escape code, assumes valid format
-                i++;
+                    while (text[i] != 'm')
+                        i++; // ignores escape code, assumes valid format
+                    i++;
 #endif
+                    break;
+                case 'r':
+                    printf("\r");
+                    i++;
+                    break;
+                case '\\':
+                    i++;
+                default:
+                    putchar(text[i]);
+                    break;
+                }
                 break;
-            case 'r':
-                printf("\r");
-                i++;
-                break;
-            case '\\':
-                i++;
+            case '$':
+                if (text[i + 1] == '?')
+                {
+                    printf("%d", last_command_output);
+                    i++;
+                    break;
+                }
             default:
-                putchar(buffer[i]);
-                break;
-            }
-            break;
-        case '$':
-            if (buffer[i + 1] == '?')
-            {
-                printf("%d", last_command_output);
-                i++;
+                putchar(text[i]);
                 break;
             }
-        default:
-            putchar(buffer[i]);
-            break;
         }
     }
     printf("\n");
     return 0;
 }
 
-int help(void)
+int help(int argc, char *argv[])
 {
     printf("Available commands:\n");
     for (int i = 0; i < sizeof(commands) / sizeof(Command); i++)
@@ -332,23 +626,25 @@ int help(void)
     return 0;
 }
 
-int clear(void)
+int clear(int argc, char *argv[])
 {
     clearScreen();
     return 0;
 }
 
-int exit(void)
+int exit(int argc, char *argv[])
 {
-    char *buffer = strtok(NULL, " ");
     int aux = 0;
-    sscanf(buffer, "%d", &aux);
+    if (argc > 1)
+    {
+        sscanf(argv[1], "%d", &aux);
+    }
     return aux;
 }
 
-int font(void)
+int font(int argc, char *argv[])
 {
-    char *arg = strtok(NULL, " ");
+    char *arg = argc > 1 ? argv[1] : "";
     if (strcasecmp(arg, "increase") == 0)
     {
         return increaseFontSize();
@@ -362,9 +658,9 @@ int font(void)
     return 0;
 }
 
-int man(void)
+int man(int argc, char *argv[])
 {
-    char *command = strtok(NULL, " ");
+    char *command = argc > 1 ? argv[1] : NULL;
 
     if (command == NULL)
     {
@@ -385,9 +681,9 @@ int man(void)
     return 1;
 }
 
-int killcmd(void)
+int killcmd(int argc, char *argv[])
 {
-    char *arg = strtok(NULL, " ");
+    char *arg = argc > 1 ? argv[1] : NULL;
     if (arg == NULL)
     {
         perror("Missing PID\n");
@@ -411,9 +707,9 @@ int killcmd(void)
     return 1;
 }
 
-int block(void)
+int block(int argc, char *argv[])
 {
-    char *arg = strtok(NULL, " ");
+    char *arg = argc > 1 ? argv[1] : NULL;
     if (arg == NULL)
     {
         perror("Missing PID\n");
@@ -444,7 +740,7 @@ int block(void)
     return 1;
 }
 
-int memcmd(void)
+int memcmd(int argc, char *argv[])
 {
     char info[160] = {0};
     int32_t written = getMemoryState(info, sizeof(info));
@@ -459,7 +755,7 @@ int memcmd(void)
     return 0;
 }
 
-int ps(void)
+int ps(int argc, char *argv[])
 {
     ProcessInfo processes[PROCESS_SNAPSHOT_CAP] = {0};
     int32_t count = getProcesses(processes, PROCESS_SNAPSHOT_CAP);
@@ -475,7 +771,8 @@ int ps(void)
         [READY] = "READY",
         [RUNNING] = "RUNNING",
         [TERMINATED] = "TERMINATED",
-        [BLOCKED] = "BLOCKED"};
+        [BLOCKED] = "BLOCKED",
+        [ZOMBIE] = "ZOMBIE"};
 
     printStringColumn("PID", PID_COL_WIDTH);
     printSpaces(COLUMN_PADDING);
@@ -497,7 +794,7 @@ int ps(void)
         const ProcessInfo *info = &processes[i];
         const char *state = "UNKNOWN";
 
-        if (info->state >= READY && info->state <= BLOCKED && stateNames[info->state] != NULL)
+        if (info->state >= READY && info->state <= ZOMBIE && stateNames[info->state] != NULL)
         {
             state = stateNames[info->state];
         }
@@ -522,7 +819,7 @@ int ps(void)
     return 0;
 }
 
-int regs(void)
+int regs(int argc, char *argv[])
 {
     const static char *register_names[] = {
         "rax", "rbx", "rcx", "rdx", "rbp", "rdi", "rsi", "r8 ", "r9 ", "r10", "r11", "r12", "r13", "r14", "r15", "rsp", "rip", "rflags"};
@@ -547,16 +844,489 @@ int regs(void)
     return 0;
 }
 
+static uint64_t nullSyscallCycles(uint8_t legacyEntry)
+{
+    uint64_t start = readTSC();
+    for (int i = 0; i < SYSCALL_BENCH_ITERATIONS; i++)
+    {
+        nullSyscall(legacyEntry);
+    }
+    return (readTSC() - start) / SYSCALL_BENCH_ITERATIONS;
+}
+
+int syscallbench(int argc, char *argv[])
+{
+    // Warm up both paths first
+    nullSyscallCycles(1);
+    nullSyscallCycles(0);
+
+    uint64_t legacy = nullSyscallCycles(1);
+    uint64_t fast = nullSyscallCycles(0);
+
+    printf("Empty system call, average of %d calls:\n", SYSCALL_BENCH_ITERATIONS);
+    printf("\tint 80h:\t%d cycles\n", (int)legacy);
+    printf("\tsyscall:\t%d cycles\n", (int)fast);
+    if (legacy > fast)
+    {
+        printf("\tsaved:\t\t%d cycles per call (%d%%)\n", (int)(legacy - fast), (int)((legacy - fast) * 100 / legacy));
+    }
+    return 0;
+}
+
+int ioringbench(int argc, char *argv[])
+{
+    static IoRing ring;
+    if (ioRingInit(&ring, 0) != 0)
+    {
+        perror("Failed to register the submission ring\n");
+        return 1;
+    }
+
+    uint64_t completed = 0;
+    uint64_t start = readTSC();
+    for (int batch = 0; batch < IO_RING_BENCH_BATCHES; batch++)
+    {
+        for (int i = 0; i < IO_RING_ENTRIES; i++)
+        {
+            ioRingNop(&ring, i);
+        }
+        ioRingSubmit(&ring, 0);
+
+        IoCompletion completion;
+        while (ioRingNextCompletion(&ring, &completion))
+        {
+            completed++;
+        }
+    }
+    uint64_t batched = (readTSC() - start) / (IO_RING_BENCH_BATCHES * IO_RING_ENTRIES);
+    uint64_t single = nullSyscallCycles(0);
+
+    printf("Empty operation, %d completed in batches of %d:\n", (int)completed, IO_RING_ENTRIES);
+    printf("\tone syscall each:\t%d cycles\n", (int)single);
+    printf("\tsubmission ring:\t%d cycles\n", (int)batched);
+    return 0;
+}
+
+int syscalls(int argc, char *argv[])
+{
+    static SyscallStats stats[SYSCALL_STATS_CAP];
+    int32_t count = getSyscallStats(stats, SYSCALL_STATS_CAP);
+
+    if (count <= 0)
+    {
+        perror("Failed to read system call stats\n");
+        return 1;
+    }
+
+    printf("System calls, latency buckets as log2(cycles):count\n");
+    for (int i = 0; i < count; i++)
+    {
+        const SyscallStats *entry = &stats[i];
+        if (entry->calls == 0)
+        {
+            continue;
+        }
+
+        printf("%x ", (int)entry->id);
+        printStringColumn(entry->name, SYSCALL_NAME_COL_WIDTH);
+        printf(" calls: %d avg: %d\n\t", (int)entry->calls, (int)(entry->totalCycles / entry->calls));
+        for (int bucket = 0; bucket < SYSCALL_HISTOGRAM_BUCKETS; bucket++)
+        {
+            if (entry->histogram[bucket] != 0)
+            {
+                printf(" %d:%d", bucket, (int)entry->histogram[bucket]);
+            }
+        }
+        printf("\n");
+    }
+
+    return 0;
+}
+
+int irqstat(int argc, char *argv[])
+{
+    IrqStats stats[IRQ_SOURCE_COUNT];
+    int32_t count = getIrqStats(stats, IRQ_SOURCE_COUNT);
+
+    if (count <= 0)
+    {
+        perror("Failed to read interrupt stats\n");
+        return 1;
+    }
+
+    printf("Interrupt latency in cycles, buckets as log2(cycles):count\n");
+    for (int i = 0; i < count; i++)
+    {
+        const IrqStats *entry = &stats[i];
+        printStringColumn(entry->name, IRQ_NAME_COL_WIDTH);
+        if (entry->count == 0)
+        {
+            printf(" never\n");
+            continue;
+        }
+
+        printf(" count: %lu avg: %lu max: %lu\n\t", entry->count, entry->totalCycles / entry->count, entry->maxCycles);
+        for (int bucket = 0; bucket < IRQ_HISTOGRAM_BUCKETS; bucket++)
+        {
+            if (entry->histogram[bucket] != 0)
+            {
+                printf(" %d:%lu", bucket, entry->histogram[bucket]);
+            }
+        }
+        printf("\n");
+    }
+
+    return 0;
+}
+
+typedef struct
+{
+    uint64_t address;
+    const char *name; // not NUL terminated, it points into the symbol table
+    int nameLength;
+} Symbol;
+
+typedef struct
+{
+    int pid;
+    int symbol; // -1 when the address is not covered by the symbol table
+    int samples;
+} ProfileEntry;
+
+static Symbol symbols[PROFILE_MAX_SYMBOLS];
+static int symbolCount = -1; // parsed on first use
+
+// Parses the "<hex address> <name>" lines of the symbol table, already sorted by address
+static int loadSymbols(void)
+{
+    if (symbolCount >= 0)
+    {
+        return symbolCount;
+    }
+
+    symbolCount = 0;
+    const char *table = NULL;
+    int32_t length = getSymbolTable(&table);
+    if (length <= 0)
+    {
+        return 0;
+    }
+
+    const char *cursor = table;
+    const char *end = table + length;
+    while (cursor < end && symbolCount < PROFILE_MAX_SYMBOLS)
+    {
+        uint64_t address = 0;
+        for (;; cursor++)
+        {
+            char c = *cursor;
+            if (c >= '0' && c <= '9')
+                address = address * 16 + (c - '0');
+            else if (c >= 'a' && c <= 'f')
+                address = address * 16 + (c - 'a' + 10);
+            else
+                break;
+        }
+        if (cursor >= end || *cursor != ' ')
+        {
+            break;
+        }
+        cursor++;
+
+        Symbol *symbol = &symbols[symbolCount++];
+        symbol->address = address;
+        symbol->name = cursor;
+        while (cursor < end && *cursor != '\n')
+        {
+            cursor++;
+        }
+        symbol->nameLength = cursor - symbol->name;
+        cursor++;
+    }
+
+    return symbolCount;
+}
+
+// Index of the function `address` falls in: the last symbol at or below it
+static int findSymbol(uint64_t address)
+{
+    int low = 0;
+    int high = symbolCount - 1;
+    int found = -1;
+    while (low <= high)
+    {
+        int middle = (low + high) / 2;
+        if (symbols[middle].address <= address)
+        {
+            found = middle;
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle - 1;
+        }
+    }
+    return found;
+}
+
+int profile(int argc, char *argv[])
+{
+    static ProfileSample samples[PROFILER_MAX_SAMPLES];
+    static ProfileEntry entries[PROFILE_MAX_ENTRIES];
+
+    char *secondsArg = argc > 1 ? argv[1] : NULL;
+    int seconds = 0;
+    if (parsePid(secondsArg, &seconds) != 0 || seconds <= 0 || seconds > PROFILE_MAX_SECONDS)
+    {
+        perror("Usage: profile <seconds>, up to 60\n");
+        return 1;
+    }
+
+    if (loadSymbols() == 0)
+    {
+        perror("No symbol table, functions are shown as addresses\n");
+    }
+
+    printf("Profiling for %d seconds...\n", seconds);
+    profilerStart();
+    sleep(seconds * 1000);
+    profilerStop();
+
+    int32_t count = profilerRead(samples, PROFILER_MAX_SAMPLES);
+    if (count <= 0)
+    {
+        perror("No samples were taken\n");
+        return 1;
+    }
+
+    // Samples per (pid, function). Functions that do not fit are only counted in the process total
+    int entryCount = 0;
+    int processSamples[PROCESS_MAX_COUNT + 1] = {0};
+    for (int i = 0; i < count; i++)
+    {
+        int pid = samples[i].pid;
+        if (pid <= 0 || pid > PROCESS_MAX_COUNT)
+        {
+            continue;
+        }
+        processSamples[pid]++;
+
+        int symbol = findSymbol(samples[i].rip);
+        int entry = 0;
+        while (entry < entryCount && (entries[entry].pid != pid || entries[entry].symbol != symbol))
+        {
+            entry++;
+        }
+        if (entry == entryCount)
+        {
+            if (entryCount == PROFILE_MAX_ENTRIES)
+            {
+                continue;
+            }
+            entries[entryCount++] = (ProfileEntry){.pid = pid, .symbol = symbol, .samples = 0};
+        }
+        entries[entry].samples++;
+    }
+
+    ProcessInfo processes[PROCESS_SNAPSHOT_CAP] = {0};
+    int32_t processCount = getProcesses(processes, PROCESS_SNAPSHOT_CAP);
+
+    printf("%d samples%s\n", (int)count, count == PROFILER_MAX_SAMPLES ? " (buffer full)" : "");
+    for (int pid = 1; pid <= PROCESS_MAX_COUNT; pid++)
+    {
+        if (processSamples[pid] == 0)
+        {
+            continue;
+        }
+
+        const char *name = "exited";
+        for (int i = 0; i < processCount; i++)
+        {
+            if (processes[i].pid == pid && processes[i].name != NULL)
+            {
+                name = processes[i].name;
+            }
+        }
+        printf("PID %d (%s): %d samples, %d%%\n", pid, name, processSamples[pid], processSamples[pid] * 100 / (int)count);
+
+        // Top functions, each pass takes the largest entry left and marks it as printed
+        for (int top = 0; top < PROFILE_TOP_FUNCTIONS; top++)
+        {
+            int best = -1;
+            for (int entry = 0; entry < entryCount; entry++)
+            {
+                if (entries[entry].pid == pid && entries[entry].samples > 0 && (best < 0 || entries[entry].samples > entries[best].samples))
+                {
+                    best = entry;
+                }
+            }
+            if (best < 0)
+            {
+                break;
+            }
+
+            printf("\t");
+            printIntColumn(entries[best].samples * 100 / processSamples[pid], 3);
+            printf("%%  ");
+            if (entries[best].symbol < 0)
+            {
+                printf("?\n");
+            }
+            else
+            {
+                const Symbol *symbol = &symbols[entries[best].symbol];
+                for (int i = 0; i < symbol->nameLength; i++)
+                {
+                    putchar(symbol->name[i]);
+                }
+                printf("\n");
+            }
+            entries[best].samples = -entries[best].samples;
+        }
+    }
+
+    return 0;
+}
+
+static const char *traceEventNames[] = {
+    [TRACE_SWITCH] = "switch",
+    [TRACE_PROCESS_CREATE] = "create",
+    [TRACE_PROCESS_EXIT] = "exit",
+    [TRACE_PROCESS_KILL] = "kill",
+    [TRACE_BLOCK] = "block",
+    [TRACE_UNBLOCK] = "unblock",
+    [TRACE_ALLOC] = "alloc",
+    [TRACE_FREE] = "free",
+    [TRACE_SYSCALL_ENTER] = "syscall",
+    [TRACE_SYSCALL_EXIT] = "sysret",
+};
+
+static const char *syscallName(const SyscallStats *stats, int count, uint64_t id)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (stats[i].id == id)
+        {
+            return stats[i].name;
+        }
+    }
+    return "?";
+}
+
+static void printTraceEvent(const TraceEvent *event, const SyscallStats *stats, int statsCount)
+{
+    uint16_t type = event->type;
+    const char *name = type < sizeof(traceEventNames) / sizeof(traceEventNames[0]) && traceEventNames[type] != NULL ? traceEventNames[type] : "?";
+    printf(" pid %d %s", event->pid, name);
+
+    switch (type)
+    {
+    case TRACE_SWITCH:
+        printf(" -> %d", (int)event->arg0);
+        break;
+    case TRACE_PROCESS_CREATE:
+        printf(" %d entry %p", (int)event->arg0, (void *)event->arg1);
+        break;
+    case TRACE_PROCESS_EXIT:
+    case TRACE_PROCESS_KILL:
+        printf(" %d code %d", (int)event->arg0, (int)event->arg1);
+        break;
+    case TRACE_BLOCK:
+    case TRACE_UNBLOCK:
+        printf(" %d", (int)event->arg0);
+        break;
+    case TRACE_ALLOC:
+        printf(" %lu bytes at %p", event->arg0, (void *)event->arg1);
+        break;
+    case TRACE_FREE:
+        printf(" %p", (void *)event->arg1);
+        break;
+    case TRACE_SYSCALL_ENTER:
+        printf(" %s (%lx)", syscallName(stats, statsCount, event->arg0), event->arg1);
+        break;
+    case TRACE_SYSCALL_EXIT:
+        printf(" %s = %ld", syscallName(stats, statsCount, event->arg0), (int64_t)event->arg1);
+        break;
+    }
+    printf("\n");
+}
+
+int trace(int argc, char *argv[])
+{
+    static TraceEvent window[TRACE_SHOWN_MAX]; // the last `shown` events, as a ring
+    static TraceEvent chunk[TRACE_READ_CHUNK];
+    static SyscallStats stats[SYSCALL_STATS_CAP];
+
+    char *arg = argc > 1 ? argv[1] : NULL;
+    if (arg != NULL && strcmp(arg, "on") == 0)
+    {
+        setTracing(1);
+        printf("Tracing enabled\n");
+        return 0;
+    }
+    if (arg != NULL && strcmp(arg, "off") == 0)
+    {
+        setTracing(0);
+        printf("Tracing disabled\n");
+        return 0;
+    }
+
+    int shown = TRACE_SHOWN_DEFAULT;
+    if (arg != NULL && (parsePid(arg, &shown) != 0 || shown <= 0 || shown > TRACE_SHOWN_MAX))
+    {
+        perror("Usage: trace [on | off | <events, up to 256>]\n");
+        return 1;
+    }
+
+    // Otherwise printing the trace would push the events being printed out of the buffer
+    uint8_t wasEnabled = setTracing(0);
+
+    uint64_t cursor = 0;
+    uint64_t total = 0;
+    int32_t read;
+    while ((read = readTrace(chunk, TRACE_READ_CHUNK, &cursor)) > 0)
+    {
+        for (int i = 0; i < read; i++)
+        {
+            window[total++ % shown] = chunk[i];
+        }
+    }
+
+    if (total == 0)
+    {
+        printf("No events%s\n", wasEnabled ? "" : ", tracing is off");
+        setTracing(wasEnabled);
+        return 0;
+    }
+
+    int statsCount = getSyscallStats(stats, SYSCALL_STATS_CAP);
+    uint64_t count = total < (uint64_t)shown ? total : (uint64_t)shown;
+    uint64_t first = window[(total - count) % shown].tsc;
+    uint64_t previous = first;
+
+    printf("Last %d events, cycles since the first one (+ since the previous one)\n", (int)count);
+    for (uint64_t n = total - count; n < total; n++)
+    {
+        const TraceEvent *event = &window[n % shown];
+        printf("%lu (+%lu)", event->tsc - first, event->tsc - previous);
+        printTraceEvent(event, stats, statsCount);
+        previous = event->tsc;
+    }
+
+    setTracing(wasEnabled);
+    return 0;
+}
+
 int loop(size_t seconds)
 {
     printf("Hola soy el proceso %d", seconds);
     return 0;
 }
 
-int nice(void)
+int nice(int argc, char *argv[])
 {
-    char *pidArg = strtok(NULL, " ");
-    char *priorityArg = strtok(NULL, " ");
+    char *pidArg = argc > 1 ? argv[1] : NULL;
+    char *priorityArg = argc > 2 ? argv[2] : NULL;
     if (pidArg == NULL || priorityArg == NULL)
     {
         perror("Uso: nice <pid> <prioridad>\n");
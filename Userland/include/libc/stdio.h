@@ -3,19 +3,39 @@
 
 #include <string.h>
 #include <stdarg.h>
+#include <stddef.h>
 
 #define FD_STDIN  0
 #define FD_STDOUT 1
 #define FD_STDERR 2
 
+#define EOF (-1)
+
+// Buffering modes (`setvbuf`). stdout is line buffered and stderr unbuffered by default
+// Every mode formats a whole call into the buffer first, unbuffered streams write it once the call ends
+#define _IOFBF 0 // written when the buffer fills up or on `fflush`
+#define _IOLBF 1 // written at every new line
+#define _IONBF 2 // written at the end of every call
+
 void puts(const char * str);
 void vprintf(const char * str, va_list args);
 void printf(const char * str, ...);
 void fprintf(int fd, const char * str, ...);
+void vfprintf(int fd, const char * format, va_list args);
+// Both return the length the whole output would have, `str` always ends up null terminated (if `size` > 0)
+int vsnprintf(char * str, size_t size, const char * format, va_list args);
+int snprintf(char * str, size_t size, const char * format, ...);
+// Output buffered by the calling process. A negative fd flushes every stream
+int fflush(int fd);
+int setvbuf(int fd, int mode);
+// Drops what a previous process with the same pid left buffered (killed before flushing) and restores the default modes
+// New processes call it before printing anything
+void resetStreams(void);
 int vscanf(const char * format, va_list args);
 int vsscanf(const char * buffer, const char * format, va_list args);
 int sscanf(const char * str, const char * format, ...);
 int scanf(const char * format, ...);
+// EOF once stdin is a pipe with no write end left, or a closed descriptor
 int getchar();
 void putchar(const char c);
 
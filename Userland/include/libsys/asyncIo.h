@@ -0,0 +1,32 @@
+#ifndef _ASYNC_IO_H_
+#define _ASYNC_IO_H_
+
+#include <stdint.h>
+#include <io_ring_abi.h>
+#include <draw_command_abi.h>
+
+// Queues operations in a caller owned `IoRing` and hands them to the kernel in one trap with `ioRingSubmit`
+// The ring is registered for the calling process, it must stay valid until the process exits
+// Queueing functions return 0, or -1 when the submission ring is full (submit and retry)
+
+int32_t ioRingInit(IoRing * ring, uint32_t flags);
+
+int32_t ioRingNop(IoRing * ring, uint64_t userData);
+int32_t ioRingWrite(IoRing * ring, int32_t fd, const char * buffer, uint64_t length, uint64_t userData);
+int32_t ioRingRead(IoRing * ring, int32_t fd, char * buffer, uint64_t length, uint64_t userData);
+int32_t ioRingSleep(IoRing * ring, uint64_t milliseconds, uint64_t userData);
+int32_t ioRingDraw(IoRing * ring, const DrawCommand * commands, uint64_t count, uint64_t userData);
+int32_t ioRingKill(IoRing * ring, int32_t pid, uint64_t userData);
+int32_t ioRingSetPriority(IoRing * ring, int32_t pid, int32_t priority, uint64_t userData);
+int32_t ioRingToggleBlock(IoRing * ring, int32_t pid, uint64_t userData);
+
+// Submissions queued and not consumed by the kernel yet
+uint32_t ioRingQueued(const IoRing * ring);
+
+// Hands every queued submission to the kernel and waits for `minComplete` completions. Returns the submissions consumed
+int32_t ioRingSubmit(IoRing * ring, uint32_t minComplete);
+
+// Pops the oldest completion into `completion`. Returns 0 if there is none
+uint8_t ioRingNextCompletion(IoRing * ring, IoCompletion * completion);
+
+#endif
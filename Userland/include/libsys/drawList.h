@@ -0,0 +1,26 @@
+#ifndef _DRAW_LIST_H_
+#define _DRAW_LIST_H_
+
+#include <stdint.h>
+#include <draw_command_abi.h>
+
+// Builds a list of draw commands in a caller provided buffer and submits it with a single syscall
+// The list is submitted automatically when it is full, call `drawListSubmit` at the end of every frame
+typedef struct {
+    DrawCommand * commands;
+    uint32_t capacity;
+    uint32_t count;
+} DrawList;
+
+void drawListInit(DrawList * list, DrawCommand * storage, uint32_t capacity);
+void drawListRectangle(DrawList * list, uint32_t color, uint64_t width, uint64_t height, int64_t x, int64_t y);
+void drawListCircle(DrawList * list, uint32_t color, int64_t topLeftX, int64_t topLeftY, uint64_t diameter);
+void drawListEllipse(DrawList * list, uint32_t color, int64_t topLeftX, int64_t topLeftY, uint64_t width, uint64_t height, uint32_t flags);
+void drawListLine(DrawList * list, uint32_t color, int64_t x0, int64_t y0, int64_t x1, int64_t y1);
+void drawListBlit(DrawList * list, const uint32_t * pixels, uint64_t width, uint64_t height, int64_t x, int64_t y);
+void drawListBlitRequest(DrawList * list, const BlitRequest * request, int64_t x, int64_t y);
+void drawListText(DrawList * list, uint32_t color, uint32_t backgroundColor, int64_t x, int64_t y, const char * text);
+void drawListFill(DrawList * list, uint32_t color);
+int32_t drawListSubmit(DrawList * list);
+
+#endif
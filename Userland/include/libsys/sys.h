@@ -3,6 +3,13 @@
 
 #include <stdint.h>
 #include <process_info.h>
+#include <blit_request_abi.h>
+#include <syscall_stats_abi.h>
+#include <irq_stats_abi.h>
+#include <message_queue_abi.h>
+#include <signal_abi.h>
+#include <profile_sample_abi.h>
+#include <trace_event_abi.h>
 
 // Enum of registerable keys.
 // Note: Does not include TAB or RETURN
@@ -94,6 +101,18 @@ enum REGISTERABLE_KEYS {
     F12_KEY           = 0x58
 };
 
+// Entry point of a process started with `createProcess`
+typedef int (*ProcessMain)(int argc, char * argv[]);
+
+// Entry point of a thread started with `threadCreate`
+typedef int32_t (*ThreadMain)(void * arg);
+
+// Semaphore handle, see `semOpen`. Processes share the counter, they only enter the kernel to block or wake
+typedef struct {
+    int32_t id;
+    volatile int32_t * count;
+} Semaphore;
+
 void startBeep(uint32_t nFrequence);
 void stopBeep(void);
 void setTextColor(uint32_t color);
@@ -102,12 +121,18 @@ uint8_t increaseFontSize(void);
 uint8_t decreaseFontSize(void);
 uint8_t setFontSize(uint8_t size);
 void getDate(int * hour, int * minute, int * second);
+uint64_t getTicks(void);
+int32_t getPid(void);
+uint64_t getUptimeNanoseconds(void);
 void clearScreen(void);
 
 
 void drawCircle(uint32_t color, long long int topleftX, long long int topLefyY, long long int diameter);
+void drawCircleOutline(uint32_t color, long long int topleftX, long long int topLefyY, long long int diameter);
+void drawEllipse(uint32_t color, long long int topLeftX, long long int topLeftY, long long int width, long long int height, uint8_t outline);
 void drawRectangle(uint32_t color, long long int width_pixels, long long int height_pixels, long long int initial_pos_x, long long int initial_pos_y);
 void fillVideoMemory(uint32_t hexColor);
+int32_t blit(const BlitRequest * request, int64_t x, int64_t y);
 int32_t exec(int32_t (*fnPtr)(void));
 int32_t execProgram(int32_t (*fnPtr)(void));
 void registerKey(enum REGISTERABLE_KEYS scancode, void (*fn)(enum REGISTERABLE_KEYS scancode));
@@ -117,11 +142,59 @@ int getWindowWidth(void);
 int getWindowHeight(void);
 void sleep(uint32_t milliseconds);
 int32_t getRegisterSnapshot(int64_t * registers);
+int32_t nullSyscall(uint8_t legacyEntry);
+int32_t getSyscallStats(SyscallStats * buffer, uint64_t capacity);
+int32_t getIrqStats(IrqStats * buffer, uint64_t capacity);
+void profilerStart(void);
+void profilerStop(void);
+int32_t profilerRead(ProfileSample * buffer, uint64_t capacity);
+int32_t getSymbolTable(const char ** table);
+uint8_t setTracing(uint8_t enabled);
+int32_t readTrace(TraceEvent * buffer, uint64_t capacity, uint64_t * cursor);
 int32_t getCharacterWithoutDisplay(void);
 int32_t getProcesses(ProcessInfo *buffer, uint64_t capacity);
 int32_t killProcess(int32_t pid);
 int32_t toggleBlockProcess(int32_t pid);
 int32_t getMemoryState(char *buffer, uint64_t capacity);
 int32_t setProcessPriority(int32_t pid, int32_t priority);
+int32_t createProcess(ProcessMain entry, int argc, char * argv[], int32_t priority, uint8_t foreground);
+int32_t waitPid(int32_t pid, int32_t * exitCode, int32_t options);
+void exitProcess(int32_t exitCode);
+int32_t createPipe(int32_t fds[2]);
+int32_t closeFd(int32_t fd);
+int32_t dupFd(int32_t fd);
+int32_t dup2Fd(int32_t fd, int32_t newFd);
+int32_t readFd(int32_t fd, char * buffer, int32_t count);
+int32_t writeFd(int32_t fd, const char * buffer, int32_t count);
+int32_t openSharedMemory(const char * name, uint64_t size, void ** address);
+int32_t attachSharedMemory(int32_t id, void ** address);
+int32_t detachSharedMemory(int32_t id);
+int32_t semOpen(const char * name, int32_t value, Semaphore * semaphore);
+int32_t semAttach(int32_t id, Semaphore * semaphore);
+int32_t semWait(Semaphore * semaphore);
+void semPost(Semaphore * semaphore);
+int32_t semClose(Semaphore * semaphore);
+int32_t mutexOpen(const char * name);
+int32_t mutexAttach(int32_t id);
+int32_t mutexLock(int32_t id);
+int32_t mutexUnlock(int32_t id);
+int32_t mutexClose(int32_t id);
+int32_t mqOpen(const char * name, uint32_t messageSize, uint32_t capacity);
+int32_t mqAttach(int32_t id);
+int32_t mqSendv(int32_t id, const void * messages, uint32_t count, uint32_t flags);
+int32_t mqRecvv(int32_t id, void * messages, uint32_t capacity, uint32_t flags);
+int32_t mqSend(int32_t id, const void * message, uint32_t flags);
+int32_t mqRecv(int32_t id, void * message, uint32_t flags);
+int32_t mqStats(int32_t id, MessageQueueStats * stats);
+int32_t mqClose(int32_t id);
+int32_t sendSignal(int32_t pid, int32_t signal);
+SignalHandler setSignalHandler(int32_t signal, SignalHandler handler);
+uint32_t blockSignals(uint32_t mask);
+int32_t setProcessGroup(int32_t pid, int32_t group);
+int32_t setForegroundGroup(int32_t group);
+int32_t threadCreate(ThreadMain entry, void * arg);
+int32_t threadJoin(int32_t tid, int32_t * exitCode);
+void yield(void);
+uint64_t readTSC(void);
 
 #endif
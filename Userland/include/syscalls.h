@@ -4,64 +4,35 @@
 #include <stdint.h>
 #include <sys.h>
 #include <process_info.h>
-
-// Linux syscall prototypes
-int32_t sys_write(int64_t fd, const void *buf, int64_t count);
-int32_t sys_read(int64_t fd, void *buf, int64_t count);
-
-// Custom syscall prototypes
-/* 0x80000000 */
-int32_t sys_start_beep(uint32_t nFrequence);
-/* 0x80000001 */
-int32_t sys_stop_beep(void);
-/* 0x80000002 */
-int32_t sys_fonts_text_color(uint32_t color);
-/* 0x80000003 */
-int32_t sys_fonts_background_color(uint32_t color);
-/* 0x80000007 */
-int32_t sys_fonts_decrease_size(void);
-/* 0x80000008 */
-int32_t sys_fonts_increase_size(void);
-/* 0x80000009 */
-int32_t sys_fonts_set_size(uint8_t size);
-/* 0x8000000A */
-int32_t sys_clear_screen(void);
-/* 0x8000000B */
-int32_t sys_clear_input_buffer(void);
-
-// Date syscall prototypes
-/* 0x80000010 */
-int32_t sys_hour(int *hour);
-/* 0x80000011 */
-int32_t sys_minute(int *minute);
-/* 0x80000012 */
-int32_t sys_second(int *second);
-
-int32_t sys_circle(int color, long long int topleftX, long long int topLefyY, long long int diameter);
-
-int32_t sys_rectangle(int color, long long int width_pixels, long long int height_pixels, long long int initial_pos_x, long long int initial_pos_y);
-
-int32_t sys_fill_video_memory(uint32_t hexColor);
-
-int32_t sys_exec(int32_t (*fnPtr)(void));
-
-int32_t sys_register_key(uint8_t scancode, void (*fn)(enum REGISTERABLE_KEYS scancode));
-int32_t sys_register_ctrl_key(uint8_t scancode, void (*fn)(enum REGISTERABLE_KEYS scancode));
-
-int32_t sys_window_width(void);
-
-int32_t sys_window_height(void);
-
-int32_t sys_sleep_milis(uint32_t milis);
-
-int32_t sys_get_register_snapshot(int64_t *registers);
-
-int32_t sys_get_character_without_display(void);
-
-int32_t sys_get_processes(ProcessInfo *buffer, uint64_t capacity);
-int32_t sys_kill_process(int32_t pid);
-int32_t sys_toggle_block_process(int32_t pid);
-int32_t sys_get_memory_state(char *buffer, uint64_t capacity);
-int32_t sys_set_process_priority(int32_t pid, int32_t priority);
+#include <draw_command_abi.h>
+#include <syscall_stats_abi.h>
+#include <kernel_data_abi.h>
+#include <io_ring_abi.h>
+#include <irq_stats_abi.h>
+#include <message_queue_abi.h>
+#include <signal_abi.h>
+#include <profile_sample_abi.h>
+#include <trace_event_abi.h>
+
+// Key handlers as userland sees them, the kernel spells the same type with its own key enum
+typedef void (*SpecialKeyHandler)(enum REGISTERABLE_KEYS scancode);
+
+// System call numbers (e.g. `sys_write_number`) and prototypes. The libsys stubs and the kernel's dispatch table are built from the same list
+enum SYSCALL_NUMBERS {
+#define SYSCALL(id, name, params) name##_number = (id),
+#define LINUX_SYSCALL SYSCALL
+#include <syscall_table.def>
+#undef SYSCALL
+#undef LINUX_SYSCALL
+};
+
+#define SYSCALL(id, name, params) int32_t name params;
+#define LINUX_SYSCALL SYSCALL
+#include <syscall_table.def>
+#undef SYSCALL
+#undef LINUX_SYSCALL
+
+// `sys_nop` through the legacy int 80h entry
+int32_t sys_nop_int80(void);
 
 #endif
@@ -6,69 +6,295 @@
     #include <ansiColors.h>
 #endif
 
-static char buffer[64] = {0};
+#define STDIO_BUFFER_SIZE 256
+#define OUTPUT_STREAMS 2 // FD_STDOUT and FD_STDERR, writes to FD_STDIN go straight to the kernel
+
+// Processes share this module's data, so every process gets its own streams (indexed by pid)
+typedef struct {
+    char data[STDIO_BUFFER_SIZE];
+    uint16_t length;
+    uint8_t mode;
+    uint8_t modeSet; // 0 until `setvbuf`, the fd default applies
+} Stream;
+
+static Stream streams[PROCESS_MAX_COUNT + 1][OUTPUT_STREAMS];
+
+// Formatting target: a stream (`fd` >= 0) or a caller provided string (`fd` == -1)
+typedef struct {
+    int fd;
+    char * string;
+    size_t size;
+    size_t length; // characters produced, including the ones that did not fit in `string`
+} Sink;
 
 static uint32_t uintToBase(uint64_t value, char * buffer, uint32_t base);
-static void printBase(int fd, int num, int base);
+static Stream * streamFor(int fd);
+static uint8_t streamMode(int fd, const Stream * stream);
+static void flushStream(int fd, Stream * stream);
+static void sinkWrite(Sink * sink, const char * s, size_t count);
+static void sinkString(Sink * sink, const char * s);
+static void sinkNumber(Sink * sink, uint64_t value, uint8_t negative, uint32_t base);
+static void sinkEnd(Sink * sink);
+static void format(Sink * sink, const char * format, va_list args);
 // static void printFloat(int fd, float num);
 
 void puts(const char * str) {
-    printf(str);
-    printf("\n");
+    Sink sink = { .fd = FD_STDOUT };
+    sinkString(&sink, str);
+    sinkWrite(&sink, "\n", 1);
+    sinkEnd(&sink);
+}
+
+void vfprintf(int fd, const char * fmt, va_list args) {
+    Sink sink = { .fd = fd };
+    format(&sink, fmt, args);
+    sinkEnd(&sink);
+}
+
+void vprintf(const char * fmt, va_list args) {
+    vfprintf(FD_STDOUT, fmt, args);
+}
+
+void printf(const char * format, ...) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(FD_STDOUT, format, args);
+    va_end(args);
+}
+
+void fprintf(int fd, const char * str, ...) {
+    va_list args;
+    va_start(args, str);
+    vfprintf(fd, str, args);
+    va_end(args);
+}
+
+int vsnprintf(char * str, size_t size, const char * fmt, va_list args) {
+    Sink sink = { .fd = -1, .string = str, .size = size };
+    format(&sink, fmt, args);
+
+    if (size > 0) {
+        str[sink.length < size ? sink.length : size - 1] = 0;
+    }
+    return (int) sink.length;
+}
+
+int snprintf(char * str, size_t size, const char * fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int aux = vsnprintf(str, size, fmt, args);
+    va_end(args);
+    return aux;
+}
+
+int fflush(int fd) {
+    if (fd < 0) {
+        fflush(FD_STDOUT);
+        fflush(FD_STDERR);
+        return 0;
+    }
+
+    Stream * stream = streamFor(fd);
+    if (stream == NULL) {
+        return -1;
+    }
+    flushStream(fd, stream);
+    return 0;
 }
 
-void vfprintf(int fd, const char * format, va_list args) {
+int setvbuf(int fd, int mode) {
+    Stream * stream = streamFor(fd);
+    if (stream == NULL || (mode != _IOFBF && mode != _IOLBF && mode != _IONBF)) {
+        return -1;
+    }
+
+    flushStream(fd, stream);
+    stream->mode = mode;
+    stream->modeSet = 1;
+    return 0;
+}
+
+void resetStreams(void) {
+    for (int fd = FD_STDOUT; fd <= FD_STDERR; fd++) {
+        Stream * stream = streamFor(fd);
+        stream->length = 0;
+        stream->modeSet = 0;
+    }
+}
+
+static void format(Sink * sink, const char * fmt, va_list args) {
     int i = 0;
-    while (format[i] != 0) {
-        switch (format[i]) {
+    while (fmt[i] != 0) {
+        switch (fmt[i]) {
         case '\e':
+            if (sink->fd < 0) { // kept as is, interpreted when the string gets printed
+                sinkWrite(sink, &fmt[i], 1);
+                i++;
+                break ;
+            }
         #ifdef ANSI_4_BIT_COLOR_SUPPORT
-            sys_write(fd, &format[i], 0); // "writes" (ignored because of count=0) \e char to account for fd changes
-            parseANSI(format, &i);
+            fflush(-1); // colors apply from here on, everything before must be printed with the previous ones
+            sys_write(sink->fd, &fmt[i], 0); // "writes" (ignored because of count=0) \e char to account for fd changes
+            parseANSI(fmt, &i);
             break ;
         #else
-            while(format[i] != 'm') i++; // ignore ANSI escape codes, assumes valid \e[X,Ym format
+            while(fmt[i] != 'm') i++; // ignore ANSI escape codes, assumes valid \e[X,Ym format
             i++;
             break ;
         #endif
-        case '%':
+        case '%': {
             i++;
-            switch (format[i]) {
-                case 'x': printBase(fd, va_arg(args, int), 16); break ;
-                case 'd': printBase(fd, va_arg(args, int), 10); break ;
-                case 'o': printBase(fd, va_arg(args, int), 8); break ;
-                case 'b': printBase(fd, va_arg(args, int), 2); break ;
+            uint8_t longs = 0; // `l` or `ll`, both are 64 bits
+            while (fmt[i] == 'l') {
+                longs++;
+                i++;
+            }
+
+            switch (fmt[i]) {
+                case 'd':
+                case 'i': {
+                    int64_t num = longs ? va_arg(args, int64_t) : va_arg(args, int);
+                    sinkNumber(sink, num < 0 ? -(uint64_t) num : (uint64_t) num, num < 0, 10);
+                    break ;
+                }
+                case 'u': sinkNumber(sink, longs ? va_arg(args, uint64_t) : va_arg(args, unsigned int), 0, 10); break ;
+                case 'x': sinkNumber(sink, longs ? va_arg(args, uint64_t) : va_arg(args, unsigned int), 0, 16); break ;
+                case 'o': sinkNumber(sink, longs ? va_arg(args, uint64_t) : va_arg(args, unsigned int), 0, 8); break ;
+                case 'b': sinkNumber(sink, longs ? va_arg(args, uint64_t) : va_arg(args, unsigned int), 0, 2); break ;
+                case 'p':
+                    sinkWrite(sink, "0x", 2);
+                    sinkNumber(sink, (uint64_t) va_arg(args, void *), 0, 16);
+                    break ;
                 // case 'f': printFloat(fd, va_arg(args, double)); break ;
                 case 'c': {
                     char c = (char) va_arg(args, int);
-                    sys_write(fd, &c, 1);
+                    sinkWrite(sink, &c, 1);
                     break ;
                 }
-                case 's': fprintf(fd, va_arg(args, char *)); break ;
-                case '%': sys_write(fd, "%", 1); break ;
+                case 's': sinkString(sink, va_arg(args, char *)); break ;
+                case '%': sinkWrite(sink, "%", 1); break ;
+                case 0: return ;
             }
             i++;
             break ;
-        default:
-            sys_write(fd, &format[i], 1);
-            i++;
+        }
+        default: {
+            int start = i;
+            while (fmt[i] != 0 && fmt[i] != '%' && fmt[i] != '\e') i++;
+            sinkWrite(sink, &fmt[start], i - start);
             break ;
         }
+        }
     }
 }
 
-void printf(const char * format, ...) {
-    va_list args;
-    va_start(args, format);
-    vfprintf(FD_STDOUT, format, args);
-    va_end(args);
+// Characters go to the process' buffer, which is written when a line ends (line buffered) or when it fills up
+static void sinkWrite(Sink * sink, const char * s, size_t count) {
+    if (sink->fd < 0) {
+        for (size_t i = 0; i < count; i++, sink->length++) {
+            if (sink->length + 1 < sink->size) {
+                sink->string[sink->length] = s[i];
+            }
+        }
+        return ;
+    }
+
+    Stream * stream = streamFor(sink->fd);
+    if (stream == NULL) {
+        sys_write(sink->fd, s, count);
+        return ;
+    }
+
+    // Keeps stdout and stderr in order on the screen
+    Stream * other = streamFor(sink->fd == FD_STDOUT ? FD_STDERR : FD_STDOUT);
+    flushStream(sink->fd == FD_STDOUT ? FD_STDERR : FD_STDOUT, other);
+
+    uint8_t lineBuffered = streamMode(sink->fd, stream) == _IOLBF;
+    for (size_t i = 0; i < count; i++) {
+        if (stream->length == STDIO_BUFFER_SIZE) {
+            flushStream(sink->fd, stream);
+        }
+        stream->data[stream->length++] = s[i];
+        if (lineBuffered && s[i] == '\n') {
+            flushStream(sink->fd, stream);
+        }
+    }
 }
 
-void fprintf(int fd, const char * str, ...) {
-    va_list args;
-    va_start(args, str);
-    vfprintf(fd, str, args);
-    va_end(args);
+// Strings printed to a stream may carry their own ANSI escape codes
+static void sinkString(Sink * sink, const char * s) {
+    if (s == NULL) {
+        s = "(null)";
+    }
+
+    int i = 0;
+    while (s[i] != 0) {
+        int start = i;
+        while (s[i] != 0 && (s[i] != '\e' || sink->fd < 0)) i++;
+        sinkWrite(sink, &s[start], i - start);
+
+        if (s[i] == '\e') {
+        #ifdef ANSI_4_BIT_COLOR_SUPPORT
+            fflush(-1);
+            sys_write(sink->fd, &s[i], 0);
+            parseANSI(s, &i);
+        #else
+            while(s[i] != 'm') i++;
+            i++;
+        #endif
+        }
+    }
+}
+
+static void sinkNumber(Sink * sink, uint64_t value, uint8_t negative, uint32_t base) {
+    char digits[65];
+    uint32_t count = uintToBase(value, digits, base);
+    if (negative) {
+        sinkWrite(sink, "-", 1);
+    }
+    sinkWrite(sink, digits, count);
+}
+
+// Unbuffered streams still get a single write per call
+static void sinkEnd(Sink * sink) {
+    if (sink->fd < 0) {
+        return ;
+    }
+
+    Stream * stream = streamFor(sink->fd);
+    if (stream != NULL && streamMode(sink->fd, stream) == _IONBF) {
+        flushStream(sink->fd, stream);
+    }
+}
+
+static Stream * streamFor(int fd) {
+    if (fd != FD_STDOUT && fd != FD_STDERR) {
+        return NULL;
+    }
+
+    int32_t pid = getPid();
+    if (pid < 0 || pid > PROCESS_MAX_COUNT) {
+        pid = 0;
+    }
+    return &streams[pid][fd - FD_STDOUT];
+}
+
+// stdout is line buffered and stderr unbuffered unless changed with `setvbuf`
+static uint8_t streamMode(int fd, const Stream * stream) {
+    if (stream->modeSet) {
+        return stream->mode;
+    }
+    return fd == FD_STDOUT ? _IOLBF : _IONBF;
+}
+
+static void flushStream(int fd, Stream * stream) {
+    if (stream->length == 0) {
+        return ;
+    }
+
+    uint16_t length = stream->length;
+    stream->length = 0;
+    sys_write(fd, stream->data, length);
 }
 
 int vscanf(const char * format, va_list args) {
@@ -189,18 +415,22 @@ int scanf(const char * format, ...) {
     return aux;
 }
 
+
 void perror(const char * s1) {
     fprintf(FD_STDERR, s1);
 }
 
+// Whatever was printed (a prompt, usually) must be on the screen before the keyboard echoes
 int getchar(void) {
+    fflush(-1);
     signed char c[1];
-    while(sys_read(FD_STDIN, c, 1) == -1);
-    return c[0];
+    return sys_read(FD_STDIN, c, 1) == 1 ? c[0] : EOF;
 }
 
 void putchar(const char c) {
-    sys_write(FD_STDOUT, &c, 1);
+    Sink sink = { .fd = FD_STDOUT };
+    sinkWrite(&sink, &c, 1);
+    sinkEnd(&sink);
 };
 
 static uint32_t uintToBase(uint64_t value, char * buffer, uint32_t base)
@@ -235,9 +465,3 @@ static uint32_t uintToBase(uint64_t value, char * buffer, uint32_t base)
 
 	return digits;
 }
-
-static void printBase(int fd, int num, int base) {
-    if (num < 0) fprintf(fd, "-");
-    uintToBase(num, buffer, base);
-    fprintf(fd, buffer);
-}
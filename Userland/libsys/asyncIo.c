@@ -0,0 +1,83 @@
+#include <asyncIo.h>
+#include <syscalls.h>
+#include <stddef.h>
+
+#define BARRIER() __asm__ volatile ("" ::: "memory")
+
+static int32_t queue(IoRing * ring, IoOpcode opcode, int32_t fd, uint64_t address, uint64_t length, uint64_t userData);
+
+int32_t ioRingInit(IoRing * ring, uint32_t flags) {
+    ring->flags = flags;
+    return sys_io_ring_setup(ring);
+}
+
+int32_t ioRingNop(IoRing * ring, uint64_t userData) {
+    return queue(ring, IO_OP_NOP, 0, 0, 0, userData);
+}
+
+int32_t ioRingWrite(IoRing * ring, int32_t fd, const char * buffer, uint64_t length, uint64_t userData) {
+    return queue(ring, IO_OP_WRITE, fd, (uint64_t) buffer, length, userData);
+}
+
+// Completes once something can be read from `fd`, with the amount read. Console input is not echoed
+int32_t ioRingRead(IoRing * ring, int32_t fd, char * buffer, uint64_t length, uint64_t userData) {
+    return queue(ring, IO_OP_READ, fd, (uint64_t) buffer, length, userData);
+}
+
+int32_t ioRingSleep(IoRing * ring, uint64_t milliseconds, uint64_t userData) {
+    return queue(ring, IO_OP_SLEEP, 0, 0, milliseconds, userData);
+}
+
+// `commands` must stay valid until the operation completes
+int32_t ioRingDraw(IoRing * ring, const DrawCommand * commands, uint64_t count, uint64_t userData) {
+    return queue(ring, IO_OP_DRAW, 0, (uint64_t) commands, count, userData);
+}
+
+int32_t ioRingKill(IoRing * ring, int32_t pid, uint64_t userData) {
+    return queue(ring, IO_OP_KILL, pid, 0, 0, userData);
+}
+
+int32_t ioRingSetPriority(IoRing * ring, int32_t pid, int32_t priority, uint64_t userData) {
+    return queue(ring, IO_OP_SET_PRIORITY, pid, 0, (uint64_t) priority, userData);
+}
+
+int32_t ioRingToggleBlock(IoRing * ring, int32_t pid, uint64_t userData) {
+    return queue(ring, IO_OP_TOGGLE_BLOCK, pid, 0, 0, userData);
+}
+
+uint32_t ioRingQueued(const IoRing * ring) {
+    return ring->submissionTail - ring->submissionHead;
+}
+
+int32_t ioRingSubmit(IoRing * ring, uint32_t minComplete) {
+    return sys_io_ring_enter(ioRingQueued(ring), minComplete);
+}
+
+uint8_t ioRingNextCompletion(IoRing * ring, IoCompletion * completion) {
+    if (ring->completionHead == ring->completionTail) {
+        return 0;
+    }
+
+    BARRIER(); // read the entry only after seeing the tail that published it
+    *completion = ring->completions[ring->completionHead % IO_RING_COMPLETION_ENTRIES];
+    BARRIER();
+    ring->completionHead++;
+    return 1;
+}
+
+static int32_t queue(IoRing * ring, IoOpcode opcode, int32_t fd, uint64_t address, uint64_t length, uint64_t userData) {
+    if (ioRingQueued(ring) >= IO_RING_ENTRIES) {
+        return -1;
+    }
+
+    IoSubmission * submission = &ring->submissions[ring->submissionTail % IO_RING_ENTRIES];
+    submission->opcode = opcode;
+    submission->fd = fd;
+    submission->address = address;
+    submission->length = length;
+    submission->userData = userData;
+
+    BARRIER(); // the entry must be visible before the new tail
+    ring->submissionTail++;
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <drawList.h>
+#include <syscalls.h>
+#include <stddef.h>
+
+static DrawCommand * nextCommand(DrawList * list, DrawCommandType type, uint32_t color, int64_t x, int64_t y);
+
+void drawListInit(DrawList * list, DrawCommand * storage, uint32_t capacity) {
+    list->commands = storage;
+    list->capacity = capacity > DRAW_BATCH_MAX_COMMANDS ? DRAW_BATCH_MAX_COMMANDS : capacity;
+    list->count = 0;
+}
+
+int32_t drawListSubmit(DrawList * list) {
+    if (list->count == 0) {
+        return 0;
+    }
+
+    int32_t executed = sys_draw_batch(list->commands, list->count);
+    list->count = 0;
+    return executed;
+}
+
+void drawListRectangle(DrawList * list, uint32_t color, uint64_t width, uint64_t height, int64_t x, int64_t y) {
+    DrawCommand * cmd = nextCommand(list, DRAW_CMD_RECTANGLE, color, x, y);
+    cmd->args.rectangle.width = width;
+    cmd->args.rectangle.height = height;
+}
+
+void drawListCircle(DrawList * list, uint32_t color, int64_t topLeftX, int64_t topLeftY, uint64_t diameter) {
+    DrawCommand * cmd = nextCommand(list, DRAW_CMD_CIRCLE, color, topLeftX, topLeftY);
+    cmd->args.circle.diameter = diameter;
+    cmd->args.circle.flags = 0;
+}
+
+// `flags` accepts DRAW_OUTLINE
+void drawListEllipse(DrawList * list, uint32_t color, int64_t topLeftX, int64_t topLeftY, uint64_t width, uint64_t height, uint32_t flags) {
+    DrawCommand * cmd = nextCommand(list, DRAW_CMD_ELLIPSE, color, topLeftX, topLeftY);
+    cmd->args.ellipse.width = width;
+    cmd->args.ellipse.height = height;
+    cmd->args.ellipse.flags = flags;
+}
+
+void drawListLine(DrawList * list, uint32_t color, int64_t x0, int64_t y0, int64_t x1, int64_t y1) {
+    DrawCommand * cmd = nextCommand(list, DRAW_CMD_LINE, color, x0, y0);
+    cmd->args.line.x1 = x1;
+    cmd->args.line.y1 = y1;
+}
+
+void drawListBlit(DrawList * list, const uint32_t * pixels, uint64_t width, uint64_t height, int64_t x, int64_t y) {
+    DrawCommand * cmd = nextCommand(list, DRAW_CMD_BLIT, 0, x, y);
+    cmd->args.blit.pixels = pixels;
+    cmd->args.blit.width = width;
+    cmd->args.blit.height = height;
+}
+
+// `request` (and the bitmap it points to) must stay valid until the list is submitted
+void drawListBlitRequest(DrawList * list, const BlitRequest * request, int64_t x, int64_t y) {
+    DrawCommand * cmd = nextCommand(list, DRAW_CMD_BLIT_REQUEST, 0, x, y);
+    cmd->args.blitRequest.request = request;
+}
+
+// `text` must stay valid until the list is submitted
+void drawListText(DrawList * list, uint32_t color, uint32_t backgroundColor, int64_t x, int64_t y, const char * text) {
+    uint64_t length = 0;
+    while (text[length] != 0) {
+        length++;
+    }
+
+    DrawCommand * cmd = nextCommand(list, DRAW_CMD_TEXT, color, x, y);
+    cmd->args.text.text = text;
+    cmd->args.text.length = length;
+    cmd->args.text.backgroundColor = backgroundColor;
+}
+
+void drawListFill(DrawList * list, uint32_t color) {
+    nextCommand(list, DRAW_CMD_FILL, color, 0, 0);
+}
+
+static DrawCommand * nextCommand(DrawList * list, DrawCommandType type, uint32_t color, int64_t x, int64_t y) {
+    if (list->count == list->capacity) {
+        drawListSubmit(list);
+    }
+
+    DrawCommand * cmd = &list->commands[list->count++];
+    cmd->type = type;
+    cmd->color = color;
+    cmd->x = x;
+    cmd->y = y;
+    return cmd;
+}
@@ -1,5 +1,6 @@
 #include <sys.h>
 #include <syscalls.h>
+#include <stddef.h>
 
 void startBeep(uint32_t nFrequence) {
     sys_start_beep(nFrequence);
@@ -29,10 +30,59 @@ uint8_t setFontSize(uint8_t size) {
     return sys_fonts_set_size(size);
 }
 
+static const volatile KernelData * kernelData = NULL;
+
+static const volatile KernelData * kernelDataPage(void) {
+    if (kernelData == NULL) {
+        sys_get_kernel_data((const KernelData **) &kernelData);
+    }
+    return kernelData;
+}
+
+// Consistent copy of the kernel data page, retries while the kernel is in the middle of an update
+static void readKernelData(KernelData * snapshot) {
+    kernelDataPage();
+
+    uint64_t sequence;
+    do {
+        while ((sequence = kernelData->sequence) & 1);
+        __asm__ volatile ("" ::: "memory");
+        *snapshot = *kernelData;
+        __asm__ volatile ("" ::: "memory");
+    } while (kernelData->sequence != sequence);
+}
+
 void getDate(int * hour, int * minute, int * second) {
-    sys_hour(hour);
-    sys_minute(minute);
-    sys_second(second);
+    KernelData snapshot;
+    readKernelData(&snapshot);
+    *hour = snapshot.hours;
+    *minute = snapshot.minutes;
+    *second = snapshot.seconds;
+}
+
+int32_t getPid(void) {
+    return kernelDataPage()->currentPid;
+}
+
+uint64_t getTicks(void) {
+    KernelData snapshot;
+    readKernelData(&snapshot);
+    return snapshot.ticks;
+}
+
+// Monotonic time since boot, interpolated between ticks with the TSC
+uint64_t getUptimeNanoseconds(void) {
+    KernelData snapshot;
+    readKernelData(&snapshot);
+
+    uint64_t elapsed = 0;
+    if (snapshot.tscPerTick != 0) {
+        uint64_t cycles = readTSC() - snapshot.tscAtTick;
+        if (cycles > snapshot.tscPerTick) cycles = snapshot.tscPerTick; // the next tick is late, do not run ahead of it
+        elapsed = cycles * snapshot.nanosecondsPerTick / snapshot.tscPerTick;
+    }
+
+    return snapshot.nanoseconds + elapsed;
 }
 
 void clearScreen(void) {
@@ -47,6 +97,14 @@ void drawCircle(uint32_t color, long long int topleftX, long long int topLefyY,
     sys_circle(color, topleftX, topLefyY, diameter);
 }
 
+void drawCircleOutline(uint32_t color, long long int topleftX, long long int topLefyY, long long int diameter) {
+    sys_ellipse(color, topleftX, topLefyY, diameter, diameter, DRAW_OUTLINE);
+}
+
+void drawEllipse(uint32_t color, long long int topLeftX, long long int topLeftY, long long int width, long long int height, uint8_t outline) {
+    sys_ellipse(color, topLeftX, topLeftY, width, height, outline ? DRAW_OUTLINE : 0);
+}
+
 void drawRectangle(uint32_t color, long long int width_pixels, long long int height_pixels, long long int initial_pos_x, long long int initial_pos_y){
     sys_rectangle(color, width_pixels, height_pixels, initial_pos_x, initial_pos_y);
 }
@@ -55,6 +113,10 @@ void fillVideoMemory(uint32_t hexColor) {
     sys_fill_video_memory(hexColor);
 }
 
+int32_t blit(const BlitRequest * request, int64_t x, int64_t y) {
+    return sys_blit(request, x, y);
+}
+
 int32_t exec(int32_t (*fnPtr)(void)) {
     return sys_exec(fnPtr);
 }
@@ -84,6 +146,47 @@ int32_t getRegisterSnapshot(int64_t * registers) {
     return sys_get_register_snapshot(registers);
 }
 
+// Empty system call, through SYSCALL or, if `legacyEntry` is set, through `int 80h`
+int32_t nullSyscall(uint8_t legacyEntry) {
+    return legacyEntry ? sys_nop_int80() : sys_nop();
+}
+
+int32_t getSyscallStats(SyscallStats * buffer, uint64_t capacity) {
+    return sys_get_syscall_stats(buffer, capacity);
+}
+
+int32_t getIrqStats(IrqStats * buffer, uint64_t capacity) {
+    return sys_get_irq_stats(buffer, capacity);
+}
+
+// Starts the sampling profiler, the samples of the previous run are discarded
+void profilerStart(void) {
+    sys_profiler_control(1);
+}
+
+void profilerStop(void) {
+    sys_profiler_control(0);
+}
+
+int32_t profilerRead(ProfileSample * buffer, uint64_t capacity) {
+    return sys_profiler_read(buffer, capacity);
+}
+
+// Returns the symbol table length (see `profile_sample_abi.h`), 0 if the image has none
+int32_t getSymbolTable(const char ** table) {
+    return sys_get_symbol_table(table);
+}
+
+// Enables or disables the kernel tracepoints, returns whether they were enabled
+uint8_t setTracing(uint8_t enabled) {
+    return (uint8_t) sys_trace_control(enabled);
+}
+
+// Start with `*cursor` at 0 to get the oldest event still in the kernel buffer
+int32_t readTrace(TraceEvent * buffer, uint64_t capacity, uint64_t * cursor) {
+    return sys_trace_read(buffer, capacity, cursor);
+}
+
 int32_t getCharacterWithoutDisplay(void) {
     return sys_get_character_without_display();
 }
@@ -107,3 +210,214 @@ int32_t getMemoryState(char *buffer, uint64_t capacity) {
 int32_t setProcessPriority(int32_t pid, int32_t priority) {
     return sys_set_process_priority(pid, priority);
 }
+
+// Runs `entry(argc, argv)` in a new process named argv[0]. The kernel copies the arguments, `argv` can be reused right away
+// Returns the new pid, -1 on failure
+int32_t createProcess(ProcessMain entry, int argc, char * argv[], int32_t priority, uint8_t foreground) {
+    if (argc <= 0) {
+        return -1;
+    }
+    return sys_create_process((void *) entry, argv, (uint64_t) argc, priority, foreground);
+}
+
+// Blocks until the child `pid` exits and stores its exit code (if `exitCode` is not NULL). Returns -1 if it is not our child
+// With WAIT_NO_HANG in `options` it returns 0 if the child is still running
+int32_t waitPid(int32_t pid, int32_t * exitCode, int32_t options) {
+    return sys_waitpid(pid, exitCode, options);
+}
+
+// Returning from the process entry point does the same
+void exitProcess(int32_t exitCode) {
+    sys_exit(exitCode);
+}
+
+// fds[0] gets the read end and fds[1] the write end. Reads block while the pipe is empty, they return 0 once
+// every write end is closed. Children only inherit descriptors 0 to 2
+int32_t createPipe(int32_t fds[2]) {
+    return sys_pipe(fds);
+}
+
+int32_t closeFd(int32_t fd) {
+    return sys_close(fd);
+}
+
+int32_t dupFd(int32_t fd) {
+    return sys_dup(fd);
+}
+
+// `newFd` refers to the same file as `fd` afterwards, it is closed first if it was open
+int32_t dup2Fd(int32_t fd, int32_t newFd) {
+    return sys_dup2(fd, newFd);
+}
+
+// Unbuffered. Returns the bytes read, 0 at end of file (a pipe with no write end left), -1 on error
+// Reads from the console return at most one line
+int32_t readFd(int32_t fd, char * buffer, int32_t count) {
+    return sys_read(fd, buffer, count);
+}
+
+// Unbuffered, flush the stdio streams first when mixing both
+int32_t writeFd(int32_t fd, const char * buffer, int32_t count) {
+    return sys_write(fd, buffer, count);
+}
+
+// Attaches to the segment `name`, created zeroed with `size` bytes if it does not exist yet (`size` 0 only looks it up)
+// A NULL `name` creates an anonymous segment, pass its id to other processes so they can attach to it
+// Returns the segment id and stores its address, -1 on failure
+int32_t openSharedMemory(const char * name, uint64_t size, void ** address) {
+    return sys_shm_open(name, size, address);
+}
+
+// Returns the segment size and stores its address, -1 if there is no such segment
+int32_t attachSharedMemory(int32_t id, void ** address) {
+    return sys_shm_attach(id, address);
+}
+
+// The segment is freed once every process detached from it. Exiting detaches from everything
+int32_t detachSharedMemory(int32_t id) {
+    return sys_shm_detach(id);
+}
+
+// Opens the semaphore `name`, created with `value` units if it does not exist yet
+// A NULL `name` creates an anonymous one, other processes open it by id with `semAttach`. Returns the id, -1 on failure
+int32_t semOpen(const char * name, int32_t value, Semaphore * semaphore) {
+    semaphore->id = sys_sem_open(name, value, &semaphore->count);
+    return semaphore->id;
+}
+
+int32_t semAttach(int32_t id, Semaphore * semaphore) {
+    semaphore->id = sys_sem_attach(id, &semaphore->count);
+    return semaphore->id;
+}
+
+// Uncontended waits and posts are a single atomic operation on the shared counter
+// The kernel is entered only when the wait has to block or the post has a waiter to wake, it hands the unit over in FIFO order
+// Returns -1 if the kernel refused the wait (semaphore not opened, closed, or called from a key handler), the unit is not held then
+int32_t semWait(Semaphore * semaphore) {
+    if (__atomic_fetch_sub(semaphore->count, 1, __ATOMIC_ACQUIRE) > 0) {
+        return 0;
+    }
+
+    if (sys_sem_wait(semaphore->id) < 0) {
+        __atomic_fetch_add(semaphore->count, 1, __ATOMIC_RELEASE); // not waiting after all
+        return -1;
+    }
+    return 0;
+}
+
+void semPost(Semaphore * semaphore) {
+    if (__atomic_fetch_add(semaphore->count, 1, __ATOMIC_RELEASE) < 0) {
+        sys_sem_post(semaphore->id);
+    }
+}
+
+// The semaphore is freed once every process that opened it closed it. Exiting closes everything
+int32_t semClose(Semaphore * semaphore) {
+    return sys_sem_close(semaphore->id);
+}
+
+// Opens the mutex `name`, created unlocked if it does not exist yet. A NULL `name` creates an anonymous one
+// While a process waits for it, the owner runs at least at the waiter's priority. Returns the id, -1 on failure
+int32_t mutexOpen(const char * name) {
+    return sys_mutex_open(name);
+}
+
+int32_t mutexAttach(int32_t id) {
+    return sys_mutex_attach(id);
+}
+
+// Returns -1 if the caller already owns it or waiting would deadlock
+int32_t mutexLock(int32_t id) {
+    return sys_mutex_lock(id);
+}
+
+int32_t mutexUnlock(int32_t id) {
+    return sys_mutex_unlock(id);
+}
+
+int32_t mutexClose(int32_t id) {
+    return sys_mutex_close(id);
+}
+
+// Opens the queue `name`, created with `capacity` slots of `messageSize` bytes if it does not exist yet
+// A NULL `name` creates an anonymous one. Returns the id, -1 on failure
+int32_t mqOpen(const char * name, uint32_t messageSize, uint32_t capacity) {
+    return sys_mq_open(name, messageSize, capacity);
+}
+
+int32_t mqAttach(int32_t id) {
+    return sys_mq_attach(id);
+}
+
+// `messages` holds `count` consecutive messages, all queued with a single kernel entry
+// Blocks until every one fits unless `flags` has MQ_NON_BLOCKING. Returns the messages sent
+int32_t mqSendv(int32_t id, const void * messages, uint32_t count, uint32_t flags) {
+    return sys_mq_sendv(id, messages, count, flags);
+}
+
+// Takes up to `capacity` messages, blocking until there is at least one unless `flags` has MQ_NON_BLOCKING
+int32_t mqRecvv(int32_t id, void * messages, uint32_t capacity, uint32_t flags) {
+    return sys_mq_recvv(id, messages, capacity, flags);
+}
+
+int32_t mqSend(int32_t id, const void * message, uint32_t flags) {
+    return sys_mq_sendv(id, message, 1, flags);
+}
+
+int32_t mqRecv(int32_t id, void * message, uint32_t flags) {
+    return sys_mq_recvv(id, message, 1, flags);
+}
+
+int32_t mqStats(int32_t id, MessageQueueStats * stats) {
+    return sys_mq_stats(id, stats);
+}
+
+int32_t mqClose(int32_t id) {
+    return sys_mq_close(id);
+}
+
+// `pid` negative sends to every process in group -pid. Unless handled, ignored or blocked the target terminates
+// with exit code SIGNAL_EXIT_CODE(signal)
+int32_t sendSignal(int32_t pid, int32_t signal) {
+    return sys_signal_send(pid, signal);
+}
+
+// `handler` runs the next time the process is scheduled, with `signal` blocked until it returns. Also SIG_DFL or SIG_IGN
+// Returns the previous handler, SIG_DFL if the signal can not be handled (SIGKILL)
+SignalHandler setSignalHandler(int32_t signal, SignalHandler handler) {
+    SignalHandler previous = SIG_DFL;
+    sys_signal_handler(signal, handler, &previous);
+    return previous;
+}
+
+// Replaces the mask of blocked signals (SIGNAL_MASK bits), they stay pending until unblocked. Returns the previous mask
+uint32_t blockSignals(uint32_t mask) {
+    uint32_t previous = 0;
+    sys_signal_mask(mask, &previous);
+    return previous;
+}
+
+// `pid` 0 is the caller and `group` 0 a new group led by `pid`. Children start in their parent's group
+int32_t setProcessGroup(int32_t pid, int32_t group) {
+    return sys_set_process_group(pid, group);
+}
+
+// The group Ctrl+C sends SIGINT to
+int32_t setForegroundGroup(int32_t group) {
+    return sys_set_foreground_group(group);
+}
+
+// Runs `entry(arg)` in a new thread of the calling process: it shares the descriptors and the memory, with its own
+// small stack. Returns the thread id, -1 on failure. Exiting the process ends its threads
+int32_t threadCreate(ThreadMain entry, void * arg) {
+    return sys_thread_create(entry, arg);
+}
+
+// Blocks until the thread `tid` (created by the caller) returns and stores what `entry` returned. Returns -1 if it is not ours
+int32_t threadJoin(int32_t tid, int32_t * exitCode) {
+    return sys_thread_join(tid, exitCode);
+}
+
+void yield(void) {
+    sys_yield();
+}
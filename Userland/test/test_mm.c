@@ -6,7 +6,6 @@
 #include <MemoryManager.h>
 
 void *memset(void *destination, int32_t character, uint64_t length);
-extern uint8_t ctrlCIsPending(void);
 
 #define MAX_BLOCKS 128
 
@@ -45,15 +44,11 @@ uint64_t test_mm(uint64_t argc, char *argv[]) {
   createMemory(test_mm_pool, TEST_MM_POOL_SIZE);
 
   while (iterations < TEST_MM_ITERATIONS) {
-    if (ctrlCIsPending())
-      break;
     rq = 0;
     total = 0;
 
     // Request as many blocks as we can
     while (rq < MAX_BLOCKS && total < max_memory) {
-      if (ctrlCIsPending())
-        goto cleanup_iteration;
       mm_rqs[rq].size = GetUniform(max_memory - total - 1) + 1;
       mm_rqs[rq].address = allocMemory(mm_rqs[rq].size);
 
@@ -66,16 +61,12 @@ uint64_t test_mm(uint64_t argc, char *argv[]) {
     // Set
     uint32_t i;
     for (i = 0; i < rq; i++) {
-      if (ctrlCIsPending())
-        goto cleanup_iteration;
       if (mm_rqs[i].address)
         memset(mm_rqs[i].address, i, mm_rqs[i].size);
     }
 
     // Check
     for (i = 0; i < rq; i++) {
-      if (ctrlCIsPending())
-        goto cleanup_iteration;
       if (mm_rqs[i].address)
         if (!memcheck(mm_rqs[i].address, i, mm_rqs[i].size)) {
           printf("test_mm ERROR\n");
@@ -84,14 +75,10 @@ uint64_t test_mm(uint64_t argc, char *argv[]) {
     }
 
     // Free
-cleanup_iteration:
     for (i = 0; i < rq; i++)
       if (mm_rqs[i].address)
         freeMemory(mm_rqs[i].address);
 
-    if (ctrlCIsPending())
-      return 0;
-
     iterations++;
   }
 
@@ -0,0 +1,83 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <sys.h>
+#include "./include/test_util.h"
+
+#define SEM_NAME "test_sync"
+#define TOTAL_PAIR_PROCESSES 2
+
+int64_t global; // shared: every process runs from the same module
+
+static void slowInc(int64_t *p, int64_t inc) {
+  int64_t aux = *p;
+  yield(); // This makes the race condition highly probable
+  aux += inc;
+  *p = aux;
+}
+
+// argv: name, n, inc, use_sem
+static int my_process_inc(int argc, char *argv[]) {
+  uint64_t n;
+  int64_t inc;
+  int8_t use_sem;
+  Semaphore sem;
+
+  if (argc != 4)
+    return -1;
+
+  if ((n = satoi(argv[1])) <= 0)
+    return -1;
+  if ((inc = satoi(argv[2])) == 0)
+    return -1;
+  if ((use_sem = satoi(argv[3])) < 0)
+    return -1;
+
+  if (use_sem)
+    if (semOpen(SEM_NAME, 1, &sem) < 0) {
+      printf("test_sync: ERROR opening semaphore\n");
+      return -1;
+    }
+
+  uint64_t i;
+  for (i = 0; i < n; i++) {
+    if (use_sem && semWait(&sem) < 0) {
+      printf("test_sync: ERROR waiting for semaphore\n");
+      return -1;
+    }
+    slowInc(&global, inc);
+    if (use_sem)
+      semPost(&sem);
+  }
+
+  if (use_sem)
+    semClose(&sem);
+
+  return 0;
+}
+
+uint64_t test_sync(uint64_t argc, char *argv[]) { //{n, use_sem}
+  int32_t pids[2 * TOTAL_PAIR_PROCESSES];
+
+  if (argc != 2)
+    return -1;
+
+  char *argvDec[] = {"process_dec", argv[0], "-1", argv[1], NULL};
+  char *argvInc[] = {"process_inc", argv[0], "1", argv[1], NULL};
+
+  global = 0;
+
+  uint64_t i;
+  for (i = 0; i < TOTAL_PAIR_PROCESSES; i++) {
+    pids[i] = createProcess(my_process_inc, 4, argvDec, 0, 0);
+    pids[i + TOTAL_PAIR_PROCESSES] = createProcess(my_process_inc, 4, argvInc, 0, 0);
+  }
+
+  for (i = 0; i < TOTAL_PAIR_PROCESSES; i++) {
+    waitPid(pids[i], NULL, 0);
+    waitPid(pids[i + TOTAL_PAIR_PROCESSES], NULL, 0);
+  }
+
+  printf("Final value: %d\n", (int)global);
+
+  return 0;
+}